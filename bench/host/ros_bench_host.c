@@ -0,0 +1,54 @@
+#include "ros_bench.h"
+#include "scheduler.h"
+#include "timebase.h"
+#include <signal.h>
+#include <time.h>
+
+// Host port: nanoseconds from CLOCK_MONOTONIC, the tick is a direct call to
+// SysTick_Handler() and the test interrupt is a signal. The numbers track the
+// kernel's algorithmic cost between commits; they are not target timings.
+
+#define HOST_SYSTICK_EXCEPTION 15
+#define HOST_IRQ_EXCEPTION     16
+
+const char* const ros_bench_port_platform = "host";
+const char* const ros_bench_port_unit = "ns";
+
+static void bench_signal_handler(int sig) {
+    (void)sig;
+    ros_bench_irq_mark();
+}
+
+void ros_bench_port_init(void) {
+    signal(SIGUSR1, bench_signal_handler);
+}
+
+uint32_t ros_bench_port_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+
+uint32_t ros_bench_port_elapsed(uint32_t start, uint32_t end) {
+    return end - start;
+}
+
+void ros_bench_port_tick(void) {
+    uint saved = host_exception_number;
+    host_exception_number = HOST_SYSTICK_EXCEPTION;
+    SysTick_Handler();
+    host_exception_number = saved;
+}
+
+void ros_bench_port_raise_irq(void) {
+    uint saved = host_exception_number;
+    host_exception_number = HOST_IRQ_EXCEPTION;
+    raise(SIGUSR1);
+    host_exception_number = saved;
+}
+
+int main(void) {
+    ros_bench_port_init();
+    ros_bench_run_all();
+    return 0;
+}
@@ -0,0 +1,372 @@
+#include "ros_bench.h"
+#include "scheduler.h"
+#include "ros_sync.h"
+#include "xip_profile.h"
+#include "timebase.h"
+#include "cmsis_os2.h"
+#include <stdio.h>
+
+#define BENCH_ITERATIONS (ROS_BENCH_WARMUP + ROS_BENCH_SAMPLES)
+
+_Static_assert(ROS_BENCH_SAMPLES >= 100, "p99 needs at least 100 samples");
+
+static uint32_t samples[BENCH_ITERATIONS];
+static uint32_t overhead;                   // Cost of the two time stamps themselves
+static volatile uint32_t t_start;
+static volatile uint32_t t_end;
+
+static int driver_pid;                      // Low-priority process running the measurement loop
+static int helper_pid;                      // High-priority process it hands off to
+static volatile bool driver_running;
+
+static inline void mark_start(void) {
+    t_start = ros_bench_port_now();
+}
+
+static inline void mark_end(void) {
+    t_end = ros_bench_port_now();
+}
+
+void ros_bench_irq_mark(void) {
+    mark_end();
+}
+
+static void record(uint32_t i) {
+    uint32_t d = ros_bench_port_elapsed(t_start, t_end);
+    samples[i] = d > overhead ? d - overhead : 0;
+}
+
+// Shell sort: no libc dependency and fast enough for a few thousand samples
+static void sort_samples(uint32_t* v, uint32_t n) {
+    for (uint32_t gap = n / 2; gap > 0; gap /= 2) {
+        for (uint32_t i = gap; i < n; i++) {
+            uint32_t x = v[i];
+            uint32_t j = i;
+            for (; j >= gap && v[j - gap] > x; j -= gap) v[j] = v[j - gap];
+            v[j] = x;
+        }
+    }
+}
+
+static void report(const char* name) {
+    uint32_t* v = &samples[ROS_BENCH_WARMUP];
+    uint32_t n = ROS_BENCH_SAMPLES;
+    sort_samples(v, n);
+
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < n; i++) sum += v[i];
+
+    ros_bench_result_t r = {
+        .name = name,
+        .n = n,
+        .min = v[0],
+        .avg = (uint32_t)(sum / n),
+        .max = v[n - 1],
+        .p99 = v[(n * 99 + 99) / 100 - 1],   // Nearest rank
+    };
+    printf("{\"bench\":\"%s\",\"platform\":\"%s\",\"unit\":\"%s\",\"n\":%lu,\"min\":%lu,\"avg\":%lu,"
+           "\"max\":%lu,\"p99\":%lu}\n",
+           r.name, ros_bench_port_platform, ros_bench_port_unit, (unsigned long)r.n, (unsigned long)r.min,
+           (unsigned long)r.avg, (unsigned long)r.max, (unsigned long)r.p99);
+}
+
+// XIP cache counts per kernel operation over the whole run; ROS_XIP_PROFILE builds only
+static void report_xip(void) {
+#if ROS_XIP_PROFILE
+    for (int op = 0; op < XIP_PROFILE_OPS; op++) {
+        xip_profile_stats_t x;
+        xip_profile_get((xip_profile_op_t)op, &x);
+        printf("{\"xip\":\"%s\",\"platform\":\"%s\",\"calls\":%lu,\"accesses\":%lu,\"hits\":%lu}\n",
+               xip_profile_name((xip_profile_op_t)op), ros_bench_port_platform, (unsigned long)x.calls,
+               (unsigned long)x.accesses, (unsigned long)x.hits);
+    }
+#endif
+}
+
+// Run a driver process (priority 1) and an optional helper (priority 2) until
+// the driver exits. The helper runs first and blocks through the public API
+// (process_block() or a ros_sync wait) until the driver hands off to it.
+static void run_processes(void (*driver)(void), void (*helper)(void)) {
+    init_scheduler();
+    driver_running = true;
+    driver_pid = create_process(driver, 1);
+    helper_pid = helper ? create_process(helper, 2) : -1;
+    wait(driver_pid);
+}
+
+static void driver_done(void) {
+    driver_running = false;
+    exit(0);
+}
+
+static void calibrate(void) {
+    overhead = UINT32_MAX;
+    for (int i = 0; i < 64; i++) {
+        mark_start();
+        mark_end();
+        uint32_t d = ros_bench_port_elapsed(t_start, t_end);
+        if (d < overhead) overhead = d;
+    }
+}
+
+// ─────────────────────────────────────────────────────────────
+// Task switch: a yield by schedule() to the next equal-priority process resuming;
+// one pick and one context switch
+
+static void switch_driver(void) {
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        mark_start();
+        schedule();
+        record(i);
+    }
+    driver_done();
+}
+
+static void switch_peer(void) {
+    while (driver_running) {
+        mark_end();
+        schedule();
+    }
+    exit(0);
+}
+
+static void bench_task_switch(void) {
+    init_scheduler();
+    driver_running = true;
+    driver_pid = create_process(switch_driver, 1);
+    create_process(switch_peer, 1);
+    wait(driver_pid);
+    report("task_switch");
+}
+
+// ─────────────────────────────────────────────────────────────
+// Preemption: the tick finds a higher-priority sleeper due and switches to it;
+// tick entry, the sleeper scan, the pick and the switch
+
+static volatile uint64_t helper_wake_us;
+
+static void preempt_helper(void) {
+    helper_wake_us = timebase_now_us() + 20;
+    process_sleep_until(helper_wake_us);
+    mark_end();
+}
+
+static void preempt_driver(void) {
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        while (timebase_now_us() <= helper_wake_us) {
+        }
+        mark_start();
+        ros_bench_port_tick();
+        record(i);
+    }
+    driver_done();
+}
+
+static void bench_preemption(void) {
+    run_processes(preempt_driver, preempt_helper);
+    report("preemption");
+}
+
+// ─────────────────────────────────────────────────────────────
+// Interrupt latency: raising the test interrupt to the first line of its handler
+
+static void bench_irq_latency(void) {
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        mark_start();
+        ros_bench_port_raise_irq();
+        record(i);
+    }
+    report("irq_latency");
+}
+
+// ─────────────────────────────────────────────────────────────
+// Semaphore shuffle: release by the holder to the waiting process taking the token;
+// includes the wake-up and the preempting switch
+
+static ros_sem_t bench_sem;
+
+static void sem_helper(void) {
+    process_block();                        // Until the driver holds the token
+    ros_sem_acquire(&bench_sem, ROS_WAIT_FOREVER);
+    mark_end();
+    ros_sem_release(&bench_sem);
+}
+
+static void sem_driver(void) {
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        ros_sem_acquire(&bench_sem, 0);
+        process_unblock(helper_pid);        // Helper preempts, finds the token gone and waits
+        mark_start();
+        ros_sem_release(&bench_sem);
+        record(i);
+    }
+    driver_done();
+}
+
+static void bench_sem_shuffle(void) {
+    ros_sem_init(&bench_sem, 1, 1);
+    run_processes(sem_driver, sem_helper);
+    report("sem_shuffle");
+}
+
+// ─────────────────────────────────────────────────────────────
+// Deadlock break: a higher-priority process needs a mutex the running one holds;
+// from its attempt until it owns the mutex. That spans its block, the switch to
+// the holder, the unlock and the switch back. ros_mutex_t has no priority
+// inheritance, so the holder runs at its own priority, and with nothing else
+// ready no process in between can delay it.
+
+static ros_mutex_t bench_mutex;
+
+static void mutex_helper(void) {
+    process_block();                        // Until the driver holds the mutex
+    mark_start();
+    ros_mutex_lock(&bench_mutex, ROS_WAIT_FOREVER);
+    mark_end();
+    ros_mutex_unlock(&bench_mutex);
+}
+
+static void mutex_driver(void) {
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        ros_mutex_lock(&bench_mutex, 0);
+        process_unblock(helper_pid);        // Helper preempts, finds the mutex held and waits
+        ros_mutex_unlock(&bench_mutex);
+        record(i);
+    }
+    driver_done();
+}
+
+static void bench_deadlock_break(void) {
+    ros_mutex_init(&bench_mutex, false);
+    run_processes(mutex_driver, mutex_helper);
+    report("deadlock_break");
+}
+
+// ─────────────────────────────────────────────────────────────
+// Message latency: put by the sender to the waiting receiver holding the message;
+// both copies, the wake-up and the switch
+
+static ros_queue_t bench_queue;
+static uint32_t bench_queue_buf[4];
+static volatile uint32_t bench_received;
+
+static void queue_helper(void) {
+    uint32_t msg;
+    if (ros_queue_get(&bench_queue, &msg, ROS_WAIT_FOREVER)) {
+        mark_end();
+        bench_received = msg;
+    }
+}
+
+static void queue_driver(void) {
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        mark_start();
+        ros_queue_put(&bench_queue, &i, 0);
+        record(i);
+        if (bench_received != i) printf("ros_bench: message %lu lost\n", (unsigned long)i);
+    }
+    driver_done();
+}
+
+static void bench_message_latency(void) {
+    ros_queue_init(&bench_queue, bench_queue_buf, 4, sizeof(uint32_t));
+    run_processes(queue_driver, queue_helper);
+    report("message_latency");
+}
+
+// ─────────────────────────────────────────────────────────────
+// CMSIS-RTOS2 wrapper overhead: the same uncontended pair natively and through cmsis_os2.h
+
+static ros_sem_t os2_sem_cb;
+static ros_mutex_t os2_mutex_cb;
+static ros_queue_t os2_queue_cb;
+static uint32_t os2_queue_buf[4];
+static osSemaphoreId_t os2_sem;
+static osMutexId_t os2_mutex;
+static osMessageQueueId_t os2_queue;
+
+static void pair_native_sem(void) {
+    ros_sem_acquire(&bench_sem, 0);
+    ros_sem_release(&bench_sem);
+}
+
+static void pair_cmsis_sem(void) {
+    osSemaphoreAcquire(os2_sem, 0);
+    osSemaphoreRelease(os2_sem);
+}
+
+static void pair_native_mutex(void) {
+    ros_mutex_lock(&bench_mutex, 0);
+    ros_mutex_unlock(&bench_mutex);
+}
+
+static void pair_cmsis_mutex(void) {
+    osMutexAcquire(os2_mutex, 0);
+    osMutexRelease(os2_mutex);
+}
+
+static void pair_native_queue(void) {
+    uint32_t msg = 0;
+    ros_queue_put(&bench_queue, &msg, 0);
+    ros_queue_get(&bench_queue, &msg, 0);
+}
+
+static void pair_cmsis_queue(void) {
+    uint32_t msg = 0;
+    osMessageQueuePut(os2_queue, &msg, 0, 0);
+    osMessageQueueGet(os2_queue, &msg, NULL, 0);
+}
+
+static void (*pair_op)(void);
+
+static void pair_driver(void) {
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        mark_start();
+        pair_op();
+        mark_end();
+        record(i);
+    }
+    driver_done();
+}
+
+static void bench_pair(const char* name, void (*op)(void)) {
+    pair_op = op;
+    run_processes(pair_driver, NULL);
+    report(name);
+}
+
+static void bench_cmsis_overhead(void) {
+    const osSemaphoreAttr_t sem_attr = {.cb_mem = &os2_sem_cb, .cb_size = sizeof(os2_sem_cb)};
+    const osMutexAttr_t mutex_attr = {.cb_mem = &os2_mutex_cb, .cb_size = sizeof(os2_mutex_cb)};
+    const osMessageQueueAttr_t queue_attr = {.cb_mem = &os2_queue_cb, .cb_size = sizeof(os2_queue_cb),
+                                             .mq_mem = os2_queue_buf, .mq_size = sizeof(os2_queue_buf)};
+    os2_sem = osSemaphoreNew(1, 1, &sem_attr);
+    os2_mutex = osMutexNew(&mutex_attr);
+    os2_queue = osMessageQueueNew(4, sizeof(uint32_t), &queue_attr);
+    ros_sem_init(&bench_sem, 1, 1);
+    ros_mutex_init(&bench_mutex, false);
+    ros_queue_init(&bench_queue, bench_queue_buf, 4, sizeof(uint32_t));
+
+    bench_pair("native_sem_pair", pair_native_sem);
+    bench_pair("cmsis_sem_pair", pair_cmsis_sem);
+    bench_pair("native_mutex_pair", pair_native_mutex);
+    bench_pair("cmsis_mutex_pair", pair_cmsis_mutex);
+    bench_pair("native_queue_pair", pair_native_queue);
+    bench_pair("cmsis_queue_pair", pair_cmsis_queue);
+}
+
+// ─────────────────────────────────────────────────────────────
+
+void ros_bench_run_all(void) {
+    calibrate();
+    xip_profile_reset();
+    bench_task_switch();
+    bench_preemption();
+    bench_irq_latency();
+    bench_sem_shuffle();
+    bench_deadlock_break();
+    bench_message_latency();
+    bench_cmsis_overhead();
+    report_xip();
+    init_scheduler();
+}
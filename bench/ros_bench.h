@@ -0,0 +1,71 @@
+#pragma once
+/**
+ * @file ros_bench.h
+ * @brief Rhealstone-style kernel benchmarks.
+ *
+ * Each case takes ROS_BENCH_SAMPLES measurements and prints one JSON line:
+ *
+ *   {"bench":"task_switch","platform":"rp2040","unit":"cycles","n":1000,"min":..,"avg":..,"max":..,"p99":..}
+ *
+ * The cases are portable; time stamps, the scheduler tick and the test
+ * interrupt come from a small port (ros_bench_rp2040.c on target,
+ * host/ros_bench_host.c for the host build).
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Measurements per case (p99 needs at least 100)
+#ifndef ROS_BENCH_SAMPLES
+#define ROS_BENCH_SAMPLES 1000
+#endif
+
+/// Unrecorded iterations run first so caches and branch state settle
+#ifndef ROS_BENCH_WARMUP
+#define ROS_BENCH_WARMUP 16
+#endif
+
+/// @brief Summary of one case, in port units (cycles on target, ns on host).
+typedef struct {
+    const char* name;
+    uint32_t n;
+    uint32_t min;
+    uint32_t avg;
+    uint32_t max;
+    uint32_t p99;
+} ros_bench_result_t;
+
+/// @brief Run every case and print one JSON line per case.
+void ros_bench_run_all(void);
+
+/// @brief Record the end time stamp; called first thing in the port's test interrupt handler.
+void ros_bench_irq_mark(void);
+
+// ─────────────────────────────────────────────────────────────
+// Port interface
+
+/// Platform and unit names printed with every result
+extern const char* const ros_bench_port_platform;
+extern const char* const ros_bench_port_unit;
+
+/// @brief Set up the counter, the tick path and the test interrupt.
+void ros_bench_port_init(void);
+
+/// @brief Read the free-running counter.
+uint32_t ros_bench_port_now(void);
+
+/// @brief Counter ticks from `start` to `end`, handling wrap and count direction.
+uint32_t ros_bench_port_elapsed(uint32_t start, uint32_t end);
+
+/// @brief Enter the scheduler the way the SysTick tick does, and return once it has.
+void ros_bench_port_tick(void);
+
+/// @brief Raise the test interrupt; its handler calls ros_bench_irq_mark().
+void ros_bench_port_raise_irq(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,70 @@
+#include "ros_bench.h"
+#include "scheduler.h"
+#include "timebase.h"
+#include "pico/stdlib.h"
+#include "hardware/exception.h"
+#include "hardware/irq.h"
+#include "hardware/structs/scb.h"
+#include "hardware/structs/systick.h"
+#include <stdio.h>
+
+// Cycle counts come from SysTick, free-running at clk_sys with its interrupt
+// disabled (the M0+ has no DWT cycle counter). The scheduler tick is pended
+// by hand, so the measured path is the real exception entry into schedule().
+
+#define SYSTICK_MASK 0x00FFFFFFu
+
+const char* const ros_bench_port_platform = "rp2040";
+const char* const ros_bench_port_unit = "cycles";
+
+static uint bench_irq;
+
+static void bench_irq_handler(void) {
+    ros_bench_irq_mark();
+    irq_clear(bench_irq);
+}
+
+void ros_bench_port_init(void) {
+    systick_hw->csr = 0;
+    systick_hw->rvr = SYSTICK_MASK;
+    systick_hw->cvr = 0;
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+    exception_set_exclusive_handler(SYSTICK_EXCEPTION, SysTick_Handler);
+
+    bench_irq = user_irq_claim_unused(true);
+    irq_set_exclusive_handler(bench_irq, bench_irq_handler);
+    irq_set_priority(bench_irq, PICO_HIGHEST_IRQ_PRIORITY);
+    irq_set_enabled(bench_irq, true);
+}
+
+uint32_t ros_bench_port_now(void) {
+    return systick_hw->cvr;
+}
+
+uint32_t ros_bench_port_elapsed(uint32_t start, uint32_t end) {
+    return (start - end) & SYSTICK_MASK;    // Counts down
+}
+
+void ros_bench_port_tick(void) {
+    scb_hw->icsr = M0PLUS_ICSR_PENDSTSET_BITS;
+    __asm volatile("dsb\n isb" ::: "memory");
+}
+
+void ros_bench_port_raise_irq(void) {
+    irq_set_pending(bench_irq);
+    __asm volatile("dsb\n isb" ::: "memory");
+}
+
+int main(void) {
+    stdio_init_all();
+    timebase_calibrate();
+    ros_bench_port_init();
+
+    // USB CDC output is lost until a host is listening, so wait to be asked
+    for (;;) {
+        printf("ros_bench: send any byte to run (%lu Hz)\n", (unsigned long)timebase_calib.sys_hz);
+        if (getchar_timeout_us(2000000) == PICO_ERROR_TIMEOUT) continue;
+        ros_bench_run_all();
+        printf("ros_bench: done\n");
+    }
+}
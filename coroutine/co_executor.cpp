@@ -0,0 +1,195 @@
+#include "co_task.hpp"
+
+extern "C" {
+    #include "hardware/sync.h"
+}
+
+using namespace rohini;
+
+static_assert(ROHINI_CO_FRAME_SIZE % alignof(std::max_align_t) == 0,
+              "ROHINI_CO_FRAME_SIZE must keep frames aligned");
+
+// Sections are a few pointer moves, so the tasks share the kernel's sync object lock
+#define CO_LOCK() spin_lock_blocking(spin_lock_instance(PICO_SPINLOCK_ID_OS2))
+#define CO_UNLOCK(irq) spin_unlock(spin_lock_instance(PICO_SPINLOCK_ID_OS2), irq)
+
+// ─────────────────────────────────────────────────────────────
+// Frame pool
+
+union co_frame {
+    co_frame* next;
+    alignas(std::max_align_t) unsigned char bytes[ROHINI_CO_FRAME_SIZE];
+};
+
+static co_frame frames[ROHINI_CO_MAX_FRAMES];
+static co_frame* free_frames;
+static uint32_t frames_carved;      // Frames handed out at least once; the rest were never touched
+static co_pool_stats pool_stats;
+
+void* co_pool::allocate(std::size_t size) noexcept {
+    uint32_t irq = CO_LOCK();
+    if (size > pool_stats.largest_frame) pool_stats.largest_frame = static_cast<uint32_t>(size);
+
+    co_frame* frame = nullptr;
+    if (size <= ROHINI_CO_FRAME_SIZE) {
+        if (free_frames) {
+            frame = free_frames;
+            free_frames = frame->next;
+        } else if (frames_carved < ROHINI_CO_MAX_FRAMES) {
+            frame = &frames[frames_carved++];
+        }
+    }
+    if (frame) {
+        if (++pool_stats.in_use > pool_stats.peak) pool_stats.peak = pool_stats.in_use;
+    } else {
+        pool_stats.failed++;
+    }
+    CO_UNLOCK(irq);
+    return frame;
+}
+
+void co_pool::release(void* p) noexcept {
+    if (!p) return;
+    co_frame* frame = static_cast<co_frame*>(p);
+    uint32_t irq = CO_LOCK();
+    frame->next = free_frames;
+    free_frames = frame;
+    pool_stats.in_use--;
+    CO_UNLOCK(irq);
+}
+
+co_pool_stats co_pool::stats() noexcept {
+    uint32_t irq = CO_LOCK();
+    co_pool_stats s = pool_stats;
+    CO_UNLOCK(irq);
+    return s;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Executor
+
+static co_waiter* ready_head;       // FIFO of tasks to resume; interrupts append under the lock
+static co_waiter* ready_tail;
+static co_waiter* sleepers;         // Sorted by wake_us; touched only from executor context
+static uint32_t live;               // Spawned and not finished
+static int executor_pid = -1;
+
+static void ready_push(co_waiter* w) {
+    w->next = nullptr;
+    if (ready_tail) ready_tail->next = w;
+    else ready_head = w;
+    ready_tail = w;
+}
+
+// One pass per dispatch; wake() or the earliest sleeper's deadline makes the process READY again
+static void co_executor_process() {
+    do {
+        co_executor::run_ready();
+    } while (!process_block_until(co_executor::next_deadline_us()));   // false: a task was woken during the pass
+}
+
+int co_executor::launch(uint8_t priority) {
+    executor_pid = create_process(co_executor_process, priority);
+    return executor_pid;
+}
+
+bool co_executor::spawn(co_task&& task) {
+    if (!task) return false;
+    co_task::handle_type h = task.release();
+    uint32_t irq = CO_LOCK();
+    live++;
+    CO_UNLOCK(irq);
+    // The first resumption queues the promise's own waiter node
+    h.promise().start.handle = h;
+    wake(&h.promise().start);
+    return true;
+}
+
+void co_executor::wake(co_waiter* waiter) {
+    uint32_t irq = CO_LOCK();
+    ready_push(waiter);
+    CO_UNLOCK(irq);
+    if (executor_pid >= 0) process_unblock(executor_pid);
+}
+
+void co_executor::sleep(co_waiter* waiter) {
+    co_waiter** link = &sleepers;
+    while (*link && (*link)->wake_us <= waiter->wake_us) link = &(*link)->next;
+    waiter->next = *link;
+    *link = waiter;
+}
+
+void co_executor::task_finished() {
+    uint32_t irq = CO_LOCK();
+    live--;
+    CO_UNLOCK(irq);
+}
+
+uint32_t co_executor::run_ready() {
+    uint64_t now = timebase_now_us();
+    while (sleepers && sleepers->wake_us <= now) {
+        co_waiter* w = sleepers;
+        sleepers = w->next;
+        uint32_t irq = CO_LOCK();
+        ready_push(w);
+        CO_UNLOCK(irq);
+    }
+
+    // Only the tasks ready now: one that yields goes to the back for the next pass
+    uint32_t irq = CO_LOCK();
+    co_waiter* batch = ready_head;
+    ready_head = ready_tail = nullptr;
+    CO_UNLOCK(irq);
+
+    uint32_t n = 0;
+    while (batch) {
+        co_waiter* w = batch;
+        batch = w->next;
+        w->handle.resume();
+        n++;
+    }
+    return n;
+}
+
+bool co_executor::has_ready() {
+    return ready_head != nullptr;
+}
+
+uint64_t co_executor::next_deadline_us() {
+    return sleepers ? sleepers->wake_us : UINT64_MAX;
+}
+
+uint32_t co_executor::live_tasks() {
+    return live;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Event
+
+bool co_event::park(co_waiter* waiter, std::coroutine_handle<> h) {
+    uint32_t irq = CO_LOCK();
+    if (set_) {
+        set_ = false;
+        CO_UNLOCK(irq);
+        return false;
+    }
+    waiter->handle = h;
+    waiter->next = waiters_;
+    waiters_ = waiter;
+    CO_UNLOCK(irq);
+    return true;
+}
+
+void co_event::signal() {
+    uint32_t irq = CO_LOCK();
+    co_waiter* w = waiters_;
+    waiters_ = nullptr;
+    if (!w) set_ = true;
+    CO_UNLOCK(irq);
+
+    while (w) {
+        co_waiter* next = w->next;      // wake() relinks the node into the ready list
+        co_executor::wake(w);
+        w = next;
+    }
+}
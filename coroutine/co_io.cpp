@@ -0,0 +1,142 @@
+#include "co_io.hpp"
+
+extern "C" {
+    #include "hardware/irq.h"
+    #include "hardware/sync.h"
+}
+
+static_assert((ROHINI_CO_UART_RX_LEN & (ROHINI_CO_UART_RX_LEN - 1)) == 0,
+              "ROHINI_CO_UART_RX_LEN must be a power of two");
+
+// Same lock as the executor's ready list (co_executor.cpp)
+#define CO_LOCK() spin_lock_blocking(spin_lock_instance(PICO_SPINLOCK_ID_OS2))
+#define CO_UNLOCK(irq) spin_unlock(spin_lock_instance(PICO_SPINLOCK_ID_OS2), irq)
+
+namespace rohini {
+
+// ─────────────────────────────────────────────────────────────
+// GPIO edges
+
+static co_gpio_edge* volatile gpio_armed[NUM_BANK0_GPIOS];
+static volatile uint32_t gpio_armed_mask;
+static bool gpio_hooked;
+
+// Runs ahead of the SDK's callback dispatch so it sees its pins' events first
+void co_gpio_irq() {
+    uint32_t mask = gpio_armed_mask;
+    while (mask) {
+        uint pin = __builtin_ctz(mask);
+        mask &= mask - 1;
+
+        co_gpio_edge* edge = gpio_armed[pin];
+        uint32_t fired = gpio_get_irq_event_mask(pin) & edge->events_;
+        if (!fired) continue;
+        gpio_set_irq_enabled(pin, edge->events_, false);
+        gpio_acknowledge_irq(pin, fired);
+        gpio_armed[pin] = nullptr;
+        gpio_armed_mask = gpio_armed_mask & ~(1u << pin);
+        edge->fired_ = fired;
+        co_executor::wake(&edge->waiter_);
+    }
+}
+
+void co_gpio_edge::await_suspend(std::coroutine_handle<> h) noexcept {
+    waiter_.handle = h;
+    if (!gpio_hooked) {
+        irq_add_shared_handler(IO_IRQ_BANK0, co_gpio_irq, PICO_SHARED_IRQ_HANDLER_HIGHEST_ORDER_PRIORITY);
+        irq_set_enabled(IO_IRQ_BANK0, true);
+        gpio_hooked = true;
+    }
+
+    // The enable is per core, so the interrupt comes back to the core running the executor
+    uint32_t irq = save_and_disable_interrupts();
+    gpio_acknowledge_irq(pin_, events_);     // Drop an edge latched before this wait
+    gpio_armed[pin_] = this;
+    gpio_armed_mask = gpio_armed_mask | (1u << pin_);
+    gpio_set_irq_enabled(pin_, events_, true);
+    restore_interrupts(irq);
+}
+
+// ─────────────────────────────────────────────────────────────
+// UART receive
+
+struct co_uart_rx {
+    uint8_t ring[ROHINI_CO_UART_RX_LEN];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    uint32_t overruns;
+    co_waiter* volatile waiter;
+};
+
+static co_uart_rx uart_rx[NUM_UARTS];
+
+static void co_uart_irq(uint index) {
+    uart_hw_t* hw = uart_get_hw(uart_get_instance(index));
+    co_uart_rx* rx = &uart_rx[index];
+
+    uint32_t irq = CO_LOCK();
+    while (!(hw->fr & UART_UARTFR_RXFE_BITS)) {
+        uint8_t c = (uint8_t)hw->dr;
+        uint32_t head = rx->head;
+        if (head - rx->tail < ROHINI_CO_UART_RX_LEN) {
+            rx->ring[head % ROHINI_CO_UART_RX_LEN] = c;
+            rx->head = head + 1;
+        } else {
+            rx->overruns++;
+        }
+    }
+    co_waiter* w = rx->waiter;
+    if (rx->head != rx->tail) rx->waiter = nullptr;
+    else w = nullptr;
+    CO_UNLOCK(irq);
+
+    if (w) co_executor::wake(w);
+}
+
+static void co_uart0_irq() {
+    co_uart_irq(0);
+}
+
+static void co_uart1_irq() {
+    co_uart_irq(1);
+}
+
+void co_uart_rx_init(uart_inst_t* uart) {
+    uint index = uart_get_index(uart);
+    uint irq_num = index ? UART1_IRQ : UART0_IRQ;
+    irq_set_exclusive_handler(irq_num, index ? co_uart1_irq : co_uart0_irq);
+    irq_set_enabled(irq_num, true);
+    uart_set_irq_enables(uart, true, false);
+}
+
+uint32_t co_uart_rx_overruns(uart_inst_t* uart) {
+    return uart_rx[uart_get_index(uart)].overruns;
+}
+
+bool co_uart_getc::await_ready() noexcept {
+    const co_uart_rx* rx = &uart_rx[index_];
+    return rx->head != rx->tail;
+}
+
+bool co_uart_getc::await_suspend(std::coroutine_handle<> h) noexcept {
+    co_uart_rx* rx = &uart_rx[index_];
+    uint32_t irq = CO_LOCK();
+    // A byte may have landed since await_ready()
+    bool wait = rx->head == rx->tail;
+    if (wait) {
+        waiter_.handle = h;
+        rx->waiter = &waiter_;
+    }
+    CO_UNLOCK(irq);
+    return wait;
+}
+
+uint8_t co_uart_getc::await_resume() noexcept {
+    co_uart_rx* rx = &uart_rx[index_];
+    uint32_t tail = rx->tail;
+    uint8_t c = rx->ring[tail % ROHINI_CO_UART_RX_LEN];
+    rx->tail = tail + 1;
+    return c;
+}
+
+} // namespace rohini
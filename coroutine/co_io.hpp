@@ -0,0 +1,126 @@
+#pragma once
+/**
+ * @file co_io.hpp
+ * @brief Awaitables for GPIO edges, UART receive and SPI completion.
+ *
+ * Each one parks the calling task and lets the interrupt of the event hand it
+ * back to the executor, so a task waiting on I/O costs its frame and nothing
+ * else:
+ * @code
+ * rohini::co_task shell() {
+ *     for (;;) {
+ *         uint8_t c = co_await rohini::co_uart_getc(uart0);
+ *         ...
+ *     }
+ * }
+ *
+ * rohini::co_task sensor(const spi_device_t* dev) {
+ *     for (;;) {
+ *         co_await rohini::co_gpio_edge(SENSOR_INT_PIN, GPIO_IRQ_EDGE_FALL);
+ *         co_await rohini::co_spi_transfer(dev, read_fifo, 2);
+ *     }
+ * }
+ * @endcode
+ *
+ * One task at a time may wait on a given pin, and one task reads each UART.
+ */
+
+#include "co_task.hpp"
+
+extern "C" {
+    #include "hardware/gpio.h"
+    #include "hardware/uart.h"
+    #include "spi_device.h"
+}
+
+/// Receive buffer per UART, filled by the RX interrupt between reads (power of two)
+#ifndef ROHINI_CO_UART_RX_LEN
+#define ROHINI_CO_UART_RX_LEN 32
+#endif
+
+namespace rohini {
+
+/**
+ * @brief `co_await co_gpio_edge(pin, events)` waits for the next matching edge.
+ *
+ * The pin interrupt is enabled when the task suspends and disabled again
+ * when it fires. Resumes with the GPIO_IRQ_* bits that fired.
+ */
+class co_gpio_edge {
+public:
+    co_gpio_edge(uint pin, uint32_t events) : pin_(pin), events_(events) {}
+
+    bool await_ready() noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) noexcept;
+    uint32_t await_resume() noexcept { return fired_; }
+
+private:
+    friend void co_gpio_irq();
+
+    uint pin_;
+    uint32_t events_;
+    volatile uint32_t fired_ = 0;
+    co_waiter waiter_;
+};
+
+/// @brief Route `uart`'s receive interrupt into co_uart_getc(). Call after uart_init().
+void co_uart_rx_init(uart_inst_t* uart);
+
+/// @return Bytes lost because `uart`'s receive buffer was full.
+uint32_t co_uart_rx_overruns(uart_inst_t* uart);
+
+/**
+ * @brief `co_await co_uart_getc(uart)` returns the next received byte.
+ *
+ * Completes at once while bytes are buffered, so a burst is read without
+ * suspending between bytes.
+ */
+class co_uart_getc {
+public:
+    explicit co_uart_getc(uart_inst_t* uart) : index_(uart_get_index(uart)) {}
+
+    bool await_ready() noexcept;
+    bool await_suspend(std::coroutine_handle<> h) noexcept;
+    uint8_t await_resume() noexcept;
+
+private:
+    uint index_;
+    co_waiter waiter_;
+};
+
+/**
+ * @brief `co_await co_spi_transfer(dev, segs, count)` runs a transaction by DMA.
+ *
+ * Starts spi_device_transfer_async() and resumes from its completion
+ * interrupt. Resumes at once with false if the transaction could not start
+ * (invalid arguments or no frames); the completion is never signalled then.
+ */
+class co_spi_transfer {
+public:
+    co_spi_transfer(const spi_device_t* dev, const spi_segment_t* segs, uint count)
+        : dev_(dev), segs_(segs), count_(count) {}
+
+    bool await_ready() noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> h) noexcept {
+        waiter_.handle = h;
+        started_ = spi_device_transfer_async(dev_, segs_, count_, &co_spi_transfer::done, this);
+        return started_;
+    }
+
+    bool await_resume() noexcept { return started_; }
+
+private:
+    static void done(const spi_device_t* dev, void* ctx) {
+        (void)dev;
+        co_executor::wake(&static_cast<co_spi_transfer*>(ctx)->waiter_);
+    }
+
+    const spi_device_t* dev_;
+    const spi_segment_t* segs_;
+    uint count_;
+    bool started_ = false;
+    co_waiter waiter_;
+};
+
+} // namespace rohini
@@ -0,0 +1,329 @@
+#pragma once
+/**
+ * @file co_task.hpp
+ * @brief Stackless C++20 coroutine tasks run by one kernel process.
+ *
+ * A coroutine returning rohini::co_task is a cooperative task. Its frame
+ * (locals that live across a suspension, plus the promise) comes from a
+ * static pool of fixed-size blocks instead of the heap, and it never owns a
+ * stack: every task runs on the stack of the executor process while it is
+ * resumed, and gives it back at each co_await. One process slot can
+ * therefore host as many tasks as the pool has frames.
+ *
+ * Usage:
+ * @code
+ * rohini::co_task blink(uint pin) {
+ *     for (;;) {
+ *         gpio_xor_mask(1u << pin);
+ *         co_await rohini::co_sleep_us(500000);
+ *     }
+ * }
+ *
+ * Kernel::init();
+ * co_executor::launch(1);
+ * co_executor::spawn(blink(25));
+ * @endcode
+ *
+ * Suspension points: co_sleep_us()/co_sleep_until(), co_yield_now(), a
+ * co_event signalled from an interrupt, the GPIO/UART/SPI awaitables in
+ * co_io.hpp, and awaiting another co_task (the caller resumes when it ends).
+ * Frames larger than ROHINI_CO_FRAME_SIZE fail to allocate: the coroutine
+ * call then returns an empty co_task and spawn() returns false.
+ */
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+    #include "scheduler.h"
+}
+
+#include "timebase.h"
+
+/// Bytes per coroutine frame (promise, locals held across co_await, awaiters)
+#ifndef ROHINI_CO_FRAME_SIZE
+#define ROHINI_CO_FRAME_SIZE 128
+#endif
+
+/// Frames in the static pool: the most tasks (spawned or awaited) alive at once
+#ifndef ROHINI_CO_MAX_FRAMES
+#define ROHINI_CO_MAX_FRAMES 64
+#endif
+
+namespace rohini {
+
+// ─────────────────────────────────────────────────────────────
+// Frame pool
+
+/**
+ * @brief Pool usage, to size ROHINI_CO_FRAME_SIZE and ROHINI_CO_MAX_FRAMES.
+ *
+ * in_use         – frames allocated now
+ * peak           – most frames allocated at once
+ * failed         – allocations refused (frame too large or pool empty)
+ * largest_frame  – biggest frame size requested, in bytes
+ */
+struct co_pool_stats {
+    uint32_t in_use;
+    uint32_t peak;
+    uint32_t failed;
+    uint32_t largest_frame;
+};
+
+namespace co_pool {
+/// @brief Take one frame; nullptr if `size` exceeds ROHINI_CO_FRAME_SIZE or the pool is empty.
+void* allocate(std::size_t size) noexcept;
+/// @brief Return a frame taken by allocate().
+void release(void* frame) noexcept;
+/// @brief Snapshot of the pool counters.
+co_pool_stats stats() noexcept;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Waiters
+
+/**
+ * @brief A suspended coroutine parked on a wait list.
+ *
+ * Awaiters embed one; it lives in the suspended coroutine's frame, so
+ * waiting never allocates.
+ */
+struct co_waiter {
+    std::coroutine_handle<> handle;
+    co_waiter* next = nullptr;
+    uint64_t wake_us = 0;
+};
+
+// ─────────────────────────────────────────────────────────────
+// Executor
+
+class co_task;
+
+/**
+ * @brief Runs coroutine tasks inside one kernel process.
+ *
+ * The process resumes every ready task in turn, then blocks until the next
+ * sleep deadline or until an interrupt readies a task. Tasks only switch at
+ * co_await; the process itself is preempted like any other.
+ */
+class co_executor {
+public:
+    /**
+     * @brief Create the executor process.
+     *
+     * Call after init_scheduler(). Tasks may be spawned before or after.
+     * @param priority Kernel priority of the process that hosts every task.
+     * @return PID of the process, or -1 if the process table is full.
+     */
+    static int launch(uint8_t priority);
+
+    /**
+     * @brief Hand a new task to the executor; it starts at the next pass.
+     * @return false if the task is empty (its frame could not be allocated).
+     */
+    static bool spawn(co_task&& task);
+
+    /**
+     * @brief Wake expired sleepers and resume every task ready now.
+     *
+     * What the executor process does once per dispatch before it blocks
+     * until the next wake() or sleep deadline; a main loop without the
+     * process (or a host test) may call it directly.
+     * @return Number of resumptions.
+     */
+    static uint32_t run_ready();
+
+    /// @return true if a task is waiting to be resumed.
+    static bool has_ready();
+
+    /// @return Earliest sleep deadline, or UINT64_MAX when no task sleeps.
+    static uint64_t next_deadline_us();
+
+    /// @return Spawned tasks that have not finished.
+    static uint32_t live_tasks();
+
+    /**
+     * @brief Make a parked coroutine ready and wake the executor process.
+     *
+     * Safe from interrupt handlers and either core; for custom awaitables.
+     */
+    static void wake(co_waiter* waiter);
+
+    /// @brief Queue a sleeper; executor context only (co_sleep_until uses it).
+    static void sleep(co_waiter* waiter);
+
+    /// @brief Called when a spawned task completes.
+    static void task_finished();
+};
+
+// ─────────────────────────────────────────────────────────────
+// Task
+
+/**
+ * @brief Return type of a cooperative coroutine task.
+ *
+ * Created suspended. Either spawn() it (the executor then owns it and frees
+ * the frame when it finishes) or co_await it from another task (the awaiting
+ * task resumes when it finishes; the frame is freed with the co_task).
+ */
+class co_task {
+public:
+    struct promise_type;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    struct final_awaiter {
+        bool await_ready() noexcept { return false; }
+
+        std::coroutine_handle<> await_suspend(handle_type h) noexcept {
+            std::coroutine_handle<> next = h.promise().continuation;
+            if (next) return next;
+            // Spawned: nobody holds the co_task any more
+            h.destroy();
+            co_executor::task_finished();
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    struct promise_type {
+        std::coroutine_handle<> continuation;   // Task awaiting this one, if any
+        co_waiter start;                        // Queues the first resumption after spawn()
+
+        co_task get_return_object() noexcept { return co_task(handle_type::from_promise(*this)); }
+        static co_task get_return_object_on_allocation_failure() noexcept { return co_task(); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        final_awaiter final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { panic("co_task: unhandled exception"); }
+
+        static void* operator new(std::size_t size) noexcept { return co_pool::allocate(size); }
+        static void operator delete(void* frame) noexcept { co_pool::release(frame); }
+    };
+
+    co_task() = default;
+    co_task(co_task&& other) noexcept : handle_(other.handle_) { other.handle_ = nullptr; }
+    co_task(const co_task&) = delete;
+    co_task& operator=(const co_task&) = delete;
+
+    co_task& operator=(co_task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~co_task() {
+        if (handle_) handle_.destroy();
+    }
+
+    /// @return false if the frame could not be allocated.
+    explicit operator bool() const { return static_cast<bool>(handle_); }
+
+    /// @brief Give up ownership of the frame (spawn() uses this).
+    handle_type release() {
+        handle_type h = handle_;
+        handle_ = nullptr;
+        return h;
+    }
+
+    /// @brief `co_await child;` runs the child to completion, then resumes the caller.
+    auto operator co_await() & noexcept {
+        struct awaiter {
+            handle_type child;
+            bool await_ready() noexcept { return !child || child.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+                child.promise().continuation = caller;
+                return child;
+            }
+            void await_resume() noexcept {}
+        };
+        return awaiter{handle_};
+    }
+
+    auto operator co_await() && noexcept { return operator co_await(); }
+
+private:
+    explicit co_task(handle_type h) : handle_(h) {}
+    handle_type handle_;
+};
+
+// ─────────────────────────────────────────────────────────────
+// Awaitables
+
+/// @brief Suspend until the timebase reaches `deadline_us`.
+inline auto co_sleep_until(uint64_t deadline_us) {
+    struct awaiter {
+        co_waiter waiter;
+        bool await_ready() noexcept { return timebase_now_us() >= waiter.wake_us; }
+        void await_suspend(std::coroutine_handle<> h) noexcept {
+            waiter.handle = h;
+            co_executor::sleep(&waiter);
+        }
+        void await_resume() noexcept {}
+    };
+    awaiter a;
+    a.waiter.wake_us = deadline_us;
+    return a;
+}
+
+/// @brief Suspend for at least `us` microseconds.
+inline auto co_sleep_us(uint64_t us) {
+    return co_sleep_until(timebase_now_us() + us);
+}
+
+/// @brief Let every other ready task run once, then continue.
+inline auto co_yield_now() {
+    struct awaiter {
+        co_waiter waiter;
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) noexcept {
+            waiter.handle = h;
+            co_executor::wake(&waiter);
+        }
+        void await_resume() noexcept {}
+    };
+    return awaiter{};
+}
+
+/**
+ * @brief Event an interrupt handler (or a task) signals and tasks await.
+ *
+ * signal() resumes every task waiting at that moment. A signal with no task
+ * waiting is kept for the next co_await, so an interrupt that fires just
+ * before the task suspends is not lost; several such signals count as one.
+ */
+class co_event {
+public:
+    /// @brief Wake the waiting tasks, or latch the event. ISR-safe.
+    void signal();
+
+    /// @return true if signalled and not yet consumed by a co_await.
+    bool is_set() const { return set_; }
+
+    /// @brief Forget a latched signal.
+    void clear() { set_ = false; }
+
+    auto operator co_await() noexcept {
+        struct awaiter {
+            co_event& event;
+            co_waiter waiter;
+            bool await_ready() noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<> h) noexcept { return event.park(&waiter, h); }
+            void await_resume() noexcept {}
+        };
+        return awaiter{*this, {}};
+    }
+
+private:
+    // Consumes a latched signal (returns false: do not suspend) or parks the waiter
+    bool park(co_waiter* waiter, std::coroutine_handle<> h);
+
+    volatile bool set_ = false;
+    co_waiter* waiters_ = nullptr;
+};
+
+} // namespace rohini
@@ -0,0 +1,247 @@
+#include "adc_stream.h"
+#include "timebase.h"
+
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/clocks.h"
+
+_Static_assert(ADC_STREAM_NUM_BLOCKS >= 4 && ADC_STREAM_NUM_BLOCKS % 2 == 0,
+               "ADC_STREAM_NUM_BLOCKS must be even and at least 4");
+_Static_assert((ADC_STREAM_BLOCK_SAMPLES & (ADC_STREAM_BLOCK_SAMPLES - 1)) == 0 &&
+               ADC_STREAM_BLOCK_SAMPLES <= 16384u,
+               "ADC_STREAM_BLOCK_SAMPLES must be a power of two up to 16384 (DMA write ring)");
+
+// Each buffer is one aligned DMA write ring, so a channel restarted before it was re-armed
+// wraps over its own, just-finished block instead of running into the next buffer
+#define ADC_RING_BYTES (ADC_STREAM_BLOCK_SAMPLES * sizeof(uint16_t))
+
+typedef enum {
+    ADC_BLOCK_FREE,     // Available to be armed
+    ADC_BLOCK_DMA,      // Armed on, or being filled by, a DMA channel
+    ADC_BLOCK_READY,    // Filled and queued for the consumer
+    ADC_BLOCK_HELD      // Owned by the consumer
+} adc_block_state_t;
+
+static uint16_t adc_buffers[ADC_STREAM_NUM_BLOCKS][ADC_STREAM_BLOCK_SAMPLES]
+    __attribute__((aligned(ADC_RING_BYTES)));
+static adc_block_t adc_blocks[ADC_STREAM_NUM_BLOCKS];
+static volatile uint8_t adc_block_state[ADC_STREAM_NUM_BLOCKS];
+
+// Single-producer (DMA IRQ) / single-consumer queue of ready block indices
+static volatile uint8_t adc_ready[ADC_STREAM_NUM_BLOCKS];
+static volatile uint32_t adc_ready_head = 0;
+static volatile uint32_t adc_ready_tail = 0;
+
+// Block index each DMA channel is currently filling
+static uint adc_dma[2];
+static uint8_t adc_dma_block[2];
+
+static uint32_t adc_raw_samples;   // Samples per block, multiple of channels << shift
+static uint     adc_first_input;   // Round-robin restarts here so frames stay aligned
+static uint8_t  adc_channels;
+static uint8_t  adc_shift;
+static uint32_t adc_seq;
+static adc_stream_stats_t adc_stats;
+
+static void (*adc_notify)(void* ctx) = NULL;
+static void* adc_notify_ctx = NULL;
+
+// Average 2^shift consecutive samples of each channel, writing the result
+// over the start of the same buffer (output index never passes input index)
+static uint32_t adc_decimate(uint16_t* buf) {
+    uint32_t frames = adc_raw_samples / adc_channels;
+    if (adc_shift == 0) return frames;
+
+    uint32_t out_frames = frames >> adc_shift;
+    uint32_t span = (uint32_t)adc_channels << adc_shift;
+    for (uint32_t f = 0; f < out_frames; f++) {
+        const uint16_t* in = buf + f * span;
+        for (uint32_t c = 0; c < adc_channels; c++) {
+            uint32_t sum = 0;
+            for (uint32_t k = c; k < span; k += adc_channels) sum += in[k];
+            buf[f * adc_channels + c] = (uint16_t)(sum >> adc_shift);
+        }
+    }
+    return out_frames;
+}
+
+// Find a free block to arm next; ADC_STREAM_NUM_BLOCKS if none
+static uint32_t adc_find_free(void) {
+    for (uint32_t i = 0; i < ADC_STREAM_NUM_BLOCKS; i++) {
+        if (adc_block_state[i] == ADC_BLOCK_FREE) return i;
+    }
+    return ADC_STREAM_NUM_BLOCKS;
+}
+
+// Point a stopped channel at a block; it starts when the other channel chains to it
+static void adc_dma_arm(uint ch, uint32_t block) {
+    adc_dma_block[ch] = (uint8_t)block;
+    adc_block_state[block] = ADC_BLOCK_DMA;
+    dma_channel_set_write_addr(adc_dma[ch], adc_buffers[block], false);
+    dma_channel_set_trans_count(adc_dma[ch], adc_raw_samples, false);
+}
+
+// Stop conversions and both channels, leaving no completion pending
+static void adc_halt(void) {
+    adc_run(false);
+    for (uint ch = 0; ch < 2; ch++) {
+        // An abort can raise a spurious completion (RP2040-E13), so mask it first
+        dma_irqn_set_channel_enabled(0, adc_dma[ch], false);
+        dma_channel_abort(adc_dma[ch]);
+        dma_irqn_acknowledge_channel(0, adc_dma[ch]);
+    }
+    adc_fifo_drain();
+}
+
+// Arm two free blocks and start from the first channel of a fresh frame
+static void adc_restart(void) {
+    for (uint ch = 0; ch < 2; ch++) {
+        adc_dma_arm(ch, adc_find_free());
+        dma_irqn_set_channel_enabled(0, adc_dma[ch], true);
+    }
+    adc_select_input(adc_first_input);
+    dma_channel_start(adc_dma[0]);
+    adc_run(true);
+}
+
+static void adc_dma_complete(uint ch) {
+    uint8_t done = adc_dma_block[ch];
+
+    // The other channel finished and chained back here before this channel was re-armed:
+    // it is writing over `done` again. Drop both blocks in flight and start over.
+    if (dma_channel_is_busy(adc_dma[ch]) || dma_irqn_get_channel_status(0, adc_dma[ch ^ 1])) {
+        adc_halt();
+        adc_block_state[done] = ADC_BLOCK_FREE;
+        adc_block_state[adc_dma_block[ch ^ 1]] = ADC_BLOCK_FREE;
+        adc_stats.late_irqs++;
+        adc_seq += 2;
+        adc_restart();
+        return;
+    }
+
+    uint32_t next = adc_find_free();
+    bool dropped = next == ADC_STREAM_NUM_BLOCKS;
+    if (dropped) next = done;   // Consumer holds every spare block: drop the newest and refill it
+
+    // Re-arm first: the other channel may finish while the block below is decimated
+    adc_dma_arm(ch, next);
+
+    if (dropped) {
+        adc_stats.overruns++;
+        adc_seq++;
+    } else {
+        adc_block_t* block = &adc_blocks[done];
+        block->frames = adc_decimate(block->data);
+        block->seq = adc_seq++;
+        block->timestamp_us = timebase_now_us();
+
+        adc_block_state[done] = ADC_BLOCK_READY;
+        adc_ready[adc_ready_head % ADC_STREAM_NUM_BLOCKS] = done;
+        adc_ready_head++;
+        adc_stats.blocks++;
+    }
+
+    if (adc_hw->fcs & ADC_FCS_OVER_BITS) {
+        adc_hw->fcs = ADC_FCS_OVER_BITS;  // Write 1 to clear
+        adc_stats.fifo_overflows++;
+    }
+
+    if (!dropped && adc_notify) adc_notify(adc_notify_ctx);
+}
+
+static void adc_dma_irq_handler(void) {
+    for (uint ch = 0; ch < 2; ch++) {
+        if (dma_irqn_get_channel_status(0, adc_dma[ch])) {
+            dma_irqn_acknowledge_channel(0, adc_dma[ch]);
+            adc_dma_complete(ch);
+        }
+    }
+}
+
+bool adc_stream_init(const adc_stream_config_t* config) {
+    uint8_t mask = config->channel_mask & 0x1Fu;
+    if (!mask || config->sample_rate == 0 || config->sample_rate > ADC_STREAM_MAX_RATE) return false;
+
+    adc_channels = (uint8_t)__builtin_popcount(mask);
+    adc_shift = config->decimation_shift;
+    uint32_t span = (uint32_t)adc_channels << adc_shift;
+    if (span > ADC_STREAM_BLOCK_SAMPLES) return false;
+    adc_raw_samples = ADC_STREAM_BLOCK_SAMPLES - ADC_STREAM_BLOCK_SAMPLES % span;
+
+    // --- ADC: GPIOs, round-robin from the lowest channel, FIFO with DREQ ---
+    adc_init();
+    for (uint i = 0; i < 4; i++) {
+        if (mask & (1u << i)) adc_gpio_init(26 + i);
+    }
+    adc_set_temp_sensor_enabled(mask & (1u << 4));
+    adc_first_input = (uint)__builtin_ctz(mask);
+    adc_select_input(adc_first_input);
+    adc_set_round_robin(mask);
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_set_clkdiv((float)clock_get_hz(clk_adc) / (float)config->sample_rate - 1.0f);
+
+    // --- Blocks ---
+    for (uint i = 0; i < ADC_STREAM_NUM_BLOCKS; i++) {
+        adc_blocks[i].data = adc_buffers[i];
+        adc_blocks[i].channels = adc_channels;
+        adc_block_state[i] = ADC_BLOCK_FREE;
+    }
+    adc_ready_head = adc_ready_tail = 0;
+    adc_seq = 0;
+    adc_stats = (adc_stream_stats_t){0};
+
+    // --- Ping-pong DMA: each channel chains to the other ---
+    adc_dma[0] = dma_claim_unused_channel(true);
+    adc_dma[1] = dma_claim_unused_channel(true);
+    for (uint ch = 0; ch < 2; ch++) {
+        dma_channel_config c = dma_channel_get_default_config(adc_dma[ch]);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_ring(&c, true, (uint)__builtin_ctz(ADC_RING_BYTES));
+        channel_config_set_dreq(&c, DREQ_ADC);
+        channel_config_set_chain_to(&c, adc_dma[ch ^ 1]);
+        dma_channel_configure(adc_dma[ch], &c, adc_buffers[ch], &adc_hw->fifo, adc_raw_samples, false);
+    }
+    irq_add_shared_handler(DMA_IRQ_0, adc_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    return true;
+}
+
+void adc_stream_set_notify(void (*notify)(void* ctx), void* ctx) {
+    adc_notify = notify;
+    adc_notify_ctx = ctx;
+}
+
+void adc_stream_start(void) {
+    // Blocks left behind by a previous run: partly filled ones and unread ones are stale,
+    // only blocks the consumer still holds are kept
+    for (uint i = 0; i < ADC_STREAM_NUM_BLOCKS; i++) {
+        if (adc_block_state[i] != ADC_BLOCK_HELD) adc_block_state[i] = ADC_BLOCK_FREE;
+    }
+    adc_ready_tail = adc_ready_head;
+
+    irq_set_enabled(DMA_IRQ_0, true);
+    adc_restart();
+}
+
+void adc_stream_stop(void) {
+    adc_halt();
+}
+
+adc_block_t* adc_stream_acquire(void) {
+    if (adc_ready_tail == adc_ready_head) return NULL;
+    uint8_t index = adc_ready[adc_ready_tail % ADC_STREAM_NUM_BLOCKS];
+    adc_block_state[index] = ADC_BLOCK_HELD;
+    adc_ready_tail++;
+    return &adc_blocks[index];
+}
+
+void adc_stream_release(adc_block_t* block) {
+    adc_block_state[block - adc_blocks] = ADC_BLOCK_FREE;
+}
+
+void adc_stream_get_stats(adc_stream_stats_t* out) {
+    uint32_t irq = save_and_disable_interrupts();
+    *out = adc_stats;
+    restore_interrupts(irq);
+}
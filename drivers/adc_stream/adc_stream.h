@@ -0,0 +1,127 @@
+#pragma once
+
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ─────────────────────────────────────────────────────────────
+// Buffer geometry
+// Raw samples captured per block (rounded down to whole channel frames).
+// A power of two up to 16384: each buffer is aligned to its size for the DMA write ring.
+#ifndef ADC_STREAM_BLOCK_SAMPLES
+#define ADC_STREAM_BLOCK_SAMPLES 1024u
+#endif
+
+// Number of blocks; two are always owned by the ping-pong DMA channels,
+// the rest give the consumer slack. Must be even and at least 4.
+#ifndef ADC_STREAM_NUM_BLOCKS
+#define ADC_STREAM_NUM_BLOCKS 4u
+#endif
+
+#define ADC_STREAM_MAX_RATE 500000u  // Aggregate samples/s at ADC clkdiv 0
+
+/**
+ * @struct adc_stream_config_t
+ * @brief Streaming configuration.
+ *
+ * channel_mask      – ADC inputs to sample round-robin (bit 0-3 = GPIO26-29, bit 4 = temperature)
+ * sample_rate       – aggregate conversions per second across all channels (≤ 500000)
+ * decimation_shift  – average 2^shift consecutive samples per channel (0 = raw)
+ */
+typedef struct {
+    uint8_t  channel_mask;
+    uint32_t sample_rate;
+    uint8_t  decimation_shift;
+} adc_stream_config_t;
+
+/**
+ * @struct adc_block_t
+ * @brief A filled block handed to the consumer without copying.
+ *
+ * data          – interleaved samples, one per enabled channel per frame, lowest channel first
+ * frames        – number of frames (samples per channel) after decimation
+ * channels      – number of enabled channels
+ * seq           – block sequence number (gaps indicate dropped blocks)
+ * timestamp_us  – timebase time at which the block completed
+ */
+typedef struct {
+    uint16_t* data;
+    uint32_t  frames;
+    uint8_t   channels;
+    uint32_t  seq;
+    uint64_t  timestamp_us;
+} adc_block_t;
+
+/**
+ * @struct adc_stream_stats_t
+ * @brief Loss counters.
+ *
+ * blocks         – blocks delivered to the consumer
+ * overruns       – blocks dropped because the consumer still held every spare buffer
+ * fifo_overflows – ADC FIFO overflows (DMA could not keep up)
+ * late_irqs      – DMA interrupts serviced after the next block had already finished;
+ *                  each one drops the two blocks in flight and restarts capture
+ */
+typedef struct {
+    uint32_t blocks;
+    uint32_t overruns;
+    uint32_t fifo_overflows;
+    uint32_t late_irqs;
+} adc_stream_stats_t;
+
+/**
+ * @brief Configure the ADC, its GPIOs and the ping-pong DMA channels.
+ * @param config Streaming configuration.
+ * @return true on success, false if the configuration is invalid.
+ */
+bool adc_stream_init(const adc_stream_config_t* config);
+
+/**
+ * @brief Register a function called from the DMA interrupt whenever a block is ready.
+ *
+ * Typically used to wake the consumer process.
+ *
+ * @param notify Callback, or NULL.
+ * @param ctx Passed to the callback.
+ */
+void adc_stream_set_notify(void (*notify)(void* ctx), void* ctx);
+
+/**
+ * @brief Start free-running conversions. The DMA interrupt is serviced on the calling core.
+ *
+ * Unread blocks from a previous run are discarded; blocks the consumer still
+ * holds stay held until released.
+ */
+void adc_stream_start(void);
+
+/// @brief Stop conversions and both DMA channels, and drain the ADC FIFO.
+void adc_stream_stop(void);
+
+/**
+ * @brief Take the oldest filled block, if any.
+ *
+ * The block stays owned by the consumer, and is never overwritten by DMA,
+ * until it is passed to adc_stream_release().
+ *
+ * @return Pointer to the block, or NULL if none is ready.
+ */
+adc_block_t* adc_stream_acquire(void);
+
+/**
+ * @brief Return a block to the driver for refilling.
+ * @param block Block obtained from adc_stream_acquire().
+ */
+void adc_stream_release(adc_block_t* block);
+
+/**
+ * @brief Copy out the loss counters.
+ * @param out Destination.
+ */
+void adc_stream_get_stats(adc_stream_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
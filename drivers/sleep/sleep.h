@@ -3,25 +3,18 @@
 #include "hardware/structs/systick.h"
 #include "hardware/structs/timer.h"
 #include "hardware/structs/clocks.h"
+#include "timebase.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// ─────────────────────────────────────────────────────────────
-// Default system clock frequency (in Hz)
-// Override this macro before including if using a custom clock
-#ifndef RP2040_SYSCLK_HZ
-#define RP2040_SYSCLK_HZ 125000000u  // Default 125 MHz
-#endif
-
 // ─────────────────────────────────────────────────────────────
 // Sleep for a specified number of microseconds
-// Uses RP2040 hardware timer (timerawl), no branches
+// Uses the 64-bit timebase, so the deadline never wraps
 static inline void sleep_us(uint32_t us) {
-    uint64_t start = timer_hw->timerawl;
-    uint64_t target = start + us;
-    while (timer_hw->timerawl < target) __asm volatile("nop");
+    uint64_t target = timebase_now_us() + us;
+    while (timebase_now_us() < target) __asm volatile("nop");
 }
 
 // Sleep for a specified number of milliseconds
@@ -43,29 +36,37 @@ static inline void delayMicroseconds(uint32_t us) {
 }
 
 // Sleep for a number of CPU cycles
-// Converts cycles to microseconds using RP2040_SYSCLK_HZ
+// Calibrated busy-wait against the measured clk_sys
 static inline void sleep_cycles(uint32_t cycles) {
-    uint32_t us = cycles / (RP2040_SYSCLK_HZ / 1000000u);
-    sleep_us(us);
+    timebase_delay_cycles(cycles);
+}
+
+// Sleep for a number of nanoseconds
+// Converted to cycles with a fixed-point multiply
+static inline void sleep_ns(uint32_t ns) {
+    timebase_delay_ns(ns);
 }
 
 // Sleep for a number of SysTick ticks
-// Converts ticks to microseconds using RP2040_SYSCLK_HZ
+// SysTick counts clk_sys cycles (CLKSOURCE=1) or the 1 µs reference tick
 static inline void sleep_ticks(uint32_t ticks) {
-    uint32_t tick_us = 1000000u / RP2040_SYSCLK_HZ;
-    sleep_us(ticks * tick_us);
+    if (systick_hw->csr & M0PLUS_SYST_CSR_CLKSOURCE_BITS) {
+        sleep_cycles(ticks);
+    } else {
+        sleep_us(ticks);
+    }
 }
 
 // Get time since boot in microseconds
-// Reads directly from timerawl
+// Full 64-bit timebase, does not wrap
 static inline uint64_t micros(void) {
-    return timer_hw->timerawl;
+    return timebase_now_us();
 }
 
 // Get time since boot in milliseconds
-// Derived from timerawl
+// Derived from the 64-bit timebase by reciprocal multiply
 static inline uint32_t millis(void) {
-    return (uint32_t)(timer_hw->timerawl / 1000u);
+    return (uint32_t)timebase_us_to_ms(timebase_now_us());
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,85 @@
+#include "spi_driver.h"
+#include "timebase.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+// SPI_* backend benchmark. The same source is linked once against the SDK
+// backend (spi_bench_sdk) and once against the register backend
+// (spi_bench_cmsis); compare their JSON lines. Each case is timed over
+// SPI_BENCH_ITERATIONS calls with the 1 us timebase and reported as the
+// average per call, next to the time the frames take on the wire.
+
+#ifndef SPI_BENCH_BAUD
+#define SPI_BENCH_BAUD 31250000u    // clk_peri / 4 at 125 MHz
+#endif
+
+#ifndef SPI_BENCH_ITERATIONS
+#define SPI_BENCH_ITERATIONS 2000u
+#endif
+
+#ifndef SPI_BENCH_SCK
+#define SPI_BENCH_SCK 18
+#endif
+#ifndef SPI_BENCH_MOSI
+#define SPI_BENCH_MOSI 19
+#endif
+#ifndef SPI_BENCH_MISO
+#define SPI_BENCH_MISO 16
+#endif
+
+#define SPI_BENCH_BURST 256u
+
+#if ROS_SPI_BACKEND_CMSIS
+static const char* const spi_bench_backend = "cmsis";
+#else
+static const char* const spi_bench_backend = "sdk";
+#endif
+
+static uint8_t tx_bytes[SPI_BENCH_BURST], rx_bytes[SPI_BENCH_BURST];
+static uint16_t tx_words[SPI_BENCH_BURST / 2], rx_words[SPI_BENCH_BURST / 2];
+
+static void spi_bench_report(const char* name, uint64_t elapsed_us, uint32_t wire_bits) {
+    uint32_t avg_ns = (uint32_t)(elapsed_us * 1000u / SPI_BENCH_ITERATIONS);
+    uint32_t wire_ns = (uint32_t)((uint64_t)wire_bits * 1000000000u / SPI_BENCH_BAUD);
+    printf("{\"bench\":\"spi_%s\",\"platform\":\"rp2040\",\"backend\":\"%s\",\"unit\":\"ns\",\"n\":%lu,"
+           "\"avg\":%lu,\"wire\":%lu}\n",
+           name, spi_bench_backend, (unsigned long)SPI_BENCH_ITERATIONS, (unsigned long)avg_ns,
+           (unsigned long)wire_ns);
+}
+
+#define SPI_BENCH_CASE(name, wire_bits, call)                          \
+    do {                                                               \
+        uint64_t start = timebase_now_us();                            \
+        for (uint32_t i = 0; i < SPI_BENCH_ITERATIONS; i++) call;      \
+        spi_bench_report(name, timebase_now_us() - start, wire_bits);  \
+    } while (0)
+
+static void spi_bench_run(void) {
+    SPI_begin(SPI_BENCH_BAUD, SPI_BENCH_SCK, SPI_BENCH_MOSI, SPI_BENCH_MISO);
+
+    SPI_BENCH_CASE("begin_transaction", 0, SPI_beginTransaction(SPI_BENCH_BAUD, 0, 0));
+    SPI_BENCH_CASE("transfer", 8, (void)SPI_transfer((uint8_t)i));
+    SPI_BENCH_CASE("transfer_bytes", 8 * SPI_BENCH_BURST, SPI_transferBytes(tx_bytes, rx_bytes, SPI_BENCH_BURST));
+    SPI_BENCH_CASE("write_bytes", 8 * SPI_BENCH_BURST, SPI_writeBytes(tx_bytes, SPI_BENCH_BURST));
+
+    SPI_setDataBits(16);
+    SPI_BENCH_CASE("transfer_words", 8 * SPI_BENCH_BURST,
+                   SPI_transferWords(tx_words, rx_words, SPI_BENCH_BURST / 2));
+    SPI_BENCH_CASE("write_words", 8 * SPI_BENCH_BURST, SPI_writeWords(tx_words, SPI_BENCH_BURST / 2));
+    SPI_setDataBits(8);
+}
+
+int main(void) {
+    stdio_init_all();
+    timebase_calibrate();
+    for (uint32_t i = 0; i < SPI_BENCH_BURST; i++) tx_bytes[i] = (uint8_t)i;
+    for (uint32_t i = 0; i < SPI_BENCH_BURST / 2; i++) tx_words[i] = (uint16_t)(i * 0x0101u);
+
+    // USB CDC output is lost until a host is listening, so wait to be asked
+    for (;;) {
+        printf("spi_bench(%s): send any byte to run (%lu baud)\n", spi_bench_backend, (unsigned long)SPI_BENCH_BAUD);
+        if (getchar_timeout_us(2000000) == PICO_ERROR_TIMEOUT) continue;
+        spi_bench_run();
+        printf("spi_bench: done\n");
+    }
+}
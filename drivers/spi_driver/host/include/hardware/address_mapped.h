@@ -0,0 +1,3 @@
+#pragma once
+// Host stand-in: see spi_mock_regs.h
+#include "spi_mock_regs.h"
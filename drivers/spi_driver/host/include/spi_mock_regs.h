@@ -0,0 +1,114 @@
+#pragma once
+/**
+ * @file spi_mock_regs.h
+ * @brief Host stand-in for the pico-sdk pieces the register SPI backend uses.
+ *
+ * Only the host test of the SPI driver sees this directory. The peripheral
+ * blocks are plain structs in RAM: writes land in the fields, and the status
+ * and reset-done registers read whatever the test put there. clk_peri comes
+ * from spi_mock_clk_peri_khz, and every frequency-counter read is counted.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+typedef volatile uint32_t io_rw_32;
+typedef volatile uint32_t io_ro_32;
+typedef volatile uint32_t io_wo_32;
+
+// ─────────────────────────────────────────────────────────────
+// PL022 (same register order as hardware/structs/spi.h)
+
+typedef struct {
+    io_rw_32 cr0;
+    io_rw_32 cr1;
+    io_rw_32 dr;
+    io_rw_32 sr;
+    io_rw_32 cpsr;
+    io_rw_32 imsc;
+    io_ro_32 ris;
+    io_ro_32 mis;
+    io_rw_32 icr;
+    io_rw_32 dmacr;
+} spi_hw_t;
+
+#define SPI_SSPCR0_DSS_LSB   0u
+#define SPI_SSPCR0_DSS_BITS  0x0000000fu
+#define SPI_SSPCR0_SPO_LSB   6u
+#define SPI_SSPCR0_SPH_LSB   7u
+#define SPI_SSPCR0_SCR_LSB   8u
+#define SPI_SSPCR0_SCR_BITS  0x0000ff00u
+#define SPI_SSPCR1_SSE_BITS  0x00000002u
+#define SPI_SSPSR_TNF_BITS   0x00000002u
+#define SPI_SSPSR_RNE_BITS   0x00000004u
+#define SPI_SSPSR_BSY_BITS   0x00000010u
+#define SPI_SSPICR_RORIC_BITS 0x00000001u
+
+extern spi_hw_t spi_mock_spi0;
+#define spi0_hw (&spi_mock_spi0)
+
+// ─────────────────────────────────────────────────────────────
+// Resets, IO and pads
+
+typedef struct {
+    io_rw_32 reset;
+    io_rw_32 wdsel;
+    io_ro_32 reset_done;
+} resets_hw_t;
+
+#define RESETS_RESET_SPI0_BITS      0x00010000u
+#define RESETS_RESET_DONE_SPI0_BITS 0x00010000u
+
+typedef struct {
+    io_ro_32 status;
+    io_rw_32 ctrl;
+} io_status_ctrl_hw_t;
+
+typedef struct {
+    io_status_ctrl_hw_t io[30];
+} iobank0_hw_t;
+
+typedef struct {
+    io_rw_32 voltage_select;
+    io_rw_32 io[30];
+} padsbank0_hw_t;
+
+#define PADS_BANK0_GPIO0_IE_BITS  0x00000040u
+#define PADS_BANK0_GPIO0_PUE_BITS 0x00000008u
+#define PADS_BANK0_GPIO0_PDE_BITS 0x00000004u
+
+extern resets_hw_t spi_mock_resets;
+extern iobank0_hw_t spi_mock_io_bank0;
+extern padsbank0_hw_t spi_mock_pads_bank0;
+#define resets_hw    (&spi_mock_resets)
+#define io_bank0_hw  (&spi_mock_io_bank0)
+#define pads_bank0_hw (&spi_mock_pads_bank0)
+
+static inline void hw_set_bits(io_rw_32* addr, uint32_t mask) {
+    *addr |= mask;
+}
+
+static inline void hw_clear_bits(io_rw_32* addr, uint32_t mask) {
+    *addr &= ~mask;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Clocks
+
+#define CLOCKS_FC0_SRC_VALUE_CLK_PERI 0x0au
+
+/// clk_peri reported by the frequency counter, in kHz
+extern uint32_t spi_mock_clk_peri_khz;
+/// Number of frequency-counter measurements so far
+extern uint32_t spi_mock_clk_peri_reads;
+
+static inline uint32_t frequency_count_khz(uint src) {
+    (void)src;
+    spi_mock_clk_peri_reads++;
+    return spi_mock_clk_peri_khz;
+}
+
+// spi_device.h only needs the instance type
+typedef struct spi_inst spi_inst_t;
@@ -0,0 +1,189 @@
+#include "spi_driver.h"
+#include "spi_device.h"
+#include <stdio.h>
+#include <string.h>
+
+// Host test of the register backend (spi_driver_cmsis.c) against mock PL022,
+// reset, IO and pad registers:
+//   spi_driver_host        divisor search, register images and clk_peri re-reads
+// Prints one line per failed check and exits non-zero if any failed.
+
+spi_hw_t spi_mock_spi0;
+resets_hw_t spi_mock_resets;
+iobank0_hw_t spi_mock_io_bank0;
+padsbank0_hw_t spi_mock_pads_bank0;
+uint32_t spi_mock_clk_peri_khz;
+uint32_t spi_mock_clk_peri_reads;
+
+static uint32_t checks, failures;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        checks++;                                           \
+        if (!(cond)) {                                      \
+            failures++;                                     \
+            printf("spi_driver_host:%d: ", __LINE__);       \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+        }                                                   \
+    } while (0)
+
+static void mock_reset(uint32_t clk_peri_khz) {
+    memset(&spi_mock_spi0, 0, sizeof spi_mock_spi0);
+    memset(&spi_mock_resets, 0, sizeof spi_mock_resets);
+    memset(&spi_mock_io_bank0, 0, sizeof spi_mock_io_bank0);
+    memset(&spi_mock_pads_bank0, 0, sizeof spi_mock_pads_bank0);
+    spi_mock_resets.reset_done = RESETS_RESET_DONE_SPI0_BITS;
+    spi_mock_spi0.sr = SPI_SSPSR_TNF_BITS;
+    spi_mock_clk_peri_khz = clk_peri_khz;
+    spi_mock_clk_peri_reads = 0;
+}
+
+static uint32_t reg_cpsr(void) {
+    return spi_mock_spi0.cpsr;
+}
+
+static uint32_t reg_scr(void) {
+    return (spi_mock_spi0.cr0 & SPI_SSPCR0_SCR_BITS) >> SPI_SSPCR0_SCR_LSB;
+}
+
+static uint32_t reg_bits(void) {
+    return ((spi_mock_spi0.cr0 & SPI_SSPCR0_DSS_BITS) >> SPI_SSPCR0_DSS_LSB) + 1;
+}
+
+// ─────────────────────────────────────────────────────────────
+// spi_compute_divisors()
+
+static const uint32_t test_clocks[] = { 125000000u, 133000000u, 48000000u, 12000000u };
+static const uint32_t test_bauds[] = { 2000u,     10000u,     100000u,   400000u,   1000000u,  3000000u,
+                                       8000000u,  10000000u,  20000000u, 31250000u, 50000000u, 62500000u };
+
+static void test_divisors(void) {
+    for (size_t c = 0; c < sizeof test_clocks / sizeof test_clocks[0]; c++) {
+        uint32_t clk = test_clocks[c];
+        for (size_t b = 0; b < sizeof test_bauds / sizeof test_bauds[0]; b++) {
+            uint32_t baud = test_bauds[b];
+            uint32_t cpsr, scr;
+            uint32_t actual = spi_compute_divisors(clk, baud, &cpsr, &scr);
+
+            CHECK(cpsr >= 2 && cpsr <= 254 && cpsr % 2 == 0, "clk %lu baud %lu: CPSR %lu out of range",
+                  (unsigned long)clk, (unsigned long)baud, (unsigned long)cpsr);
+            CHECK(scr <= 255, "clk %lu baud %lu: SCR %lu out of range", (unsigned long)clk, (unsigned long)baud,
+                  (unsigned long)scr);
+            CHECK(actual == clk / (cpsr * (scr + 1)), "clk %lu baud %lu: returned %lu, registers give %lu",
+                  (unsigned long)clk, (unsigned long)baud, (unsigned long)actual,
+                  (unsigned long)(clk / (cpsr * (scr + 1))));
+
+            // Rates the PL022 can reach run at or below the request, and one SCR step faster would not
+            if (baud >= clk / (254u * 256u) && baud <= clk / 2) {
+                CHECK(actual <= baud, "clk %lu baud %lu: %lu is too fast", (unsigned long)clk,
+                      (unsigned long)baud, (unsigned long)actual);
+                CHECK(scr == 0 || clk / (cpsr * scr) > baud, "clk %lu baud %lu: SCR %lu is not the largest",
+                      (unsigned long)clk, (unsigned long)baud, (unsigned long)scr);
+            }
+        }
+    }
+}
+
+// ─────────────────────────────────────────────────────────────
+// SPI_* register images
+
+static void test_begin(void) {
+    mock_reset(125000);
+    SPI_begin(1000000, 2, 3, 4);
+
+    uint32_t cpsr, scr;
+    spi_compute_divisors(125000000u, 1000000, &cpsr, &scr);
+    CHECK(reg_cpsr() == cpsr && reg_scr() == scr, "begin: CPSR/SCR %lu/%lu, expected %lu/%lu",
+          (unsigned long)reg_cpsr(), (unsigned long)reg_scr(), (unsigned long)cpsr, (unsigned long)scr);
+    CHECK(reg_bits() == 8, "begin: %lu-bit frames", (unsigned long)reg_bits());
+    CHECK((spi_mock_spi0.cr0 & (1u << SPI_SSPCR0_SPO_LSB | 1u << SPI_SSPCR0_SPH_LSB)) == 0, "begin: not mode 0");
+    CHECK(spi_mock_spi0.cr1 == SPI_SSPCR1_SSE_BITS, "begin: SSE not set");
+    CHECK((spi_mock_resets.reset & RESETS_RESET_SPI0_BITS) == 0, "begin: SPI0 left in reset");
+    CHECK(spi_mock_io_bank0.io[2].ctrl == 1 && spi_mock_io_bank0.io[3].ctrl == 1 && spi_mock_io_bank0.io[4].ctrl == 1,
+          "begin: pins not on FUNCSEL SPI");
+    CHECK(spi_mock_pads_bank0.io[4] & PADS_BANK0_GPIO0_IE_BITS, "begin: MISO input disabled");
+    CHECK(spi_mock_clk_peri_reads == 1, "begin: clk_peri measured %lu times", (unsigned long)spi_mock_clk_peri_reads);
+}
+
+static void test_transaction(void) {
+    mock_reset(125000);
+    SPI_begin(1000000, 2, 3, 4);
+    SPI_setDataBits(12);
+    SPI_beginTransaction(4000000, 1, 1);
+
+    uint32_t cpsr, scr;
+    spi_compute_divisors(125000000u, 4000000, &cpsr, &scr);
+    CHECK(reg_cpsr() == cpsr && reg_scr() == scr, "transaction: CPSR/SCR %lu/%lu, expected %lu/%lu",
+          (unsigned long)reg_cpsr(), (unsigned long)reg_scr(), (unsigned long)cpsr, (unsigned long)scr);
+    CHECK((spi_mock_spi0.cr0 & (1u << SPI_SSPCR0_SPO_LSB | 1u << SPI_SSPCR0_SPH_LSB)) ==
+              (1u << SPI_SSPCR0_SPO_LSB | 1u << SPI_SSPCR0_SPH_LSB),
+          "transaction: not mode 3");
+    CHECK(reg_bits() == 12, "transaction: frame size %lu, expected 12", (unsigned long)reg_bits());
+    CHECK(spi_mock_clk_peri_reads == 1, "transaction: clk_peri measured again without a clock change");
+
+    // Frame size is clamped and leaves SCR alone
+    SPI_setDataBits(2);
+    CHECK(reg_bits() == 4 && reg_scr() == scr, "setDataBits(2): %lu bits, SCR %lu", (unsigned long)reg_bits(),
+          (unsigned long)reg_scr());
+    SPI_setDataBits(20);
+    CHECK(reg_bits() == 16 && reg_scr() == scr, "setDataBits(20): %lu bits, SCR %lu", (unsigned long)reg_bits(),
+          (unsigned long)reg_scr());
+    CHECK(spi_mock_spi0.cr1 == SPI_SSPCR1_SSE_BITS, "setDataBits: SSE not set again");
+}
+
+static void test_clock_change(void) {
+    mock_reset(125000);
+    SPI_begin(1000000, 2, 3, 4);
+
+    // clk_peri drops to 48 MHz (e.g. after dormant); the cached rate is kept until told
+    spi_mock_clk_peri_khz = 48000;
+    SPI_beginTransaction(1000000, 0, 0);
+    uint32_t cpsr, scr;
+    spi_compute_divisors(125000000u, 1000000, &cpsr, &scr);
+    CHECK(reg_cpsr() == cpsr && reg_scr() == scr && spi_mock_clk_peri_reads == 1,
+          "clock change: re-measured without SPI_clockChanged()");
+
+    SPI_clockChanged();
+    SPI_beginTransaction(1000000, 0, 0);
+    spi_compute_divisors(48000000u, 1000000, &cpsr, &scr);
+    CHECK(reg_cpsr() == cpsr && reg_scr() == scr, "clock change: CPSR/SCR %lu/%lu, expected %lu/%lu for 48 MHz",
+          (unsigned long)reg_cpsr(), (unsigned long)reg_scr(), (unsigned long)cpsr, (unsigned long)scr);
+    CHECK(spi_mock_clk_peri_reads == 2, "clock change: clk_peri measured %lu times, expected 2",
+          (unsigned long)spi_mock_clk_peri_reads);
+
+    // SPI_begin() always measures afresh
+    spi_mock_clk_peri_khz = 133000;
+    SPI_begin(1000000, 2, 3, 4);
+    spi_compute_divisors(133000000u, 1000000, &cpsr, &scr);
+    CHECK(reg_cpsr() == cpsr && reg_scr() == scr && spi_mock_clk_peri_reads == 3,
+          "begin after clock change: CPSR/SCR %lu/%lu, expected %lu/%lu", (unsigned long)reg_cpsr(),
+          (unsigned long)reg_scr(), (unsigned long)cpsr, (unsigned long)scr);
+}
+
+static void test_data_path(void) {
+    mock_reset(125000);
+    SPI_begin(1000000, 2, 3, 4);
+
+    // The mock DR reads back the last write, like MOSI looped to MISO for one frame
+    spi_mock_spi0.sr = SPI_SSPSR_TNF_BITS | SPI_SSPSR_RNE_BITS;
+    CHECK(SPI_transfer(0x5a) == 0x5a, "transfer: loopback byte lost");
+
+    // TX-only bursts end with an empty RX FIFO and the overrun flag cleared
+    spi_mock_spi0.sr = SPI_SSPSR_TNF_BITS;
+    const uint8_t tx[4] = { 1, 2, 3, 4 };
+    SPI_writeBytes(tx, sizeof tx);
+    CHECK(spi_mock_spi0.dr == 4, "writeBytes: last frame %lu, expected 4", (unsigned long)spi_mock_spi0.dr);
+    CHECK(spi_mock_spi0.icr == SPI_SSPICR_RORIC_BITS, "writeBytes: overrun flag not cleared");
+}
+
+int main(void) {
+    test_divisors();
+    test_begin();
+    test_transaction();
+    test_clock_change();
+    test_data_path();
+
+    printf("spi_driver_host: %lu checks, %lu failed\n", (unsigned long)checks, (unsigned long)failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,236 @@
+#include "spi_device.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+/**
+ * DMA control block, laid out like the alias-1 register group of a channel
+ * (CTRL, READ_ADDR, WRITE_ADDR, TRANS_COUNT_TRIG). A control channel copies
+ * one block into the data channel per segment; the write to TRANS_COUNT_TRIG
+ * starts it. An all-zero address/count block is a null trigger that ends the
+ * chain and raises the data channel's IRQ.
+ */
+typedef struct {
+    uint32_t ctrl;
+    const volatile void* read_addr;
+    volatile void* write_addr;
+    uint32_t count;
+} spi_dma_block_t;
+
+typedef struct {
+    spi_dma_block_t tx_blocks[SPI_DEVICE_MAX_SEGMENTS + 1];
+    spi_dma_block_t rx_blocks[SPI_DEVICE_MAX_SEGMENTS + 1];
+
+    // Register image currently loaded into the hardware
+    uint32_t cr0;
+    uint32_t cpsr;
+
+    // Data and control DMA channels
+    uint dma_tx, dma_rx, dma_tx_ctrl, dma_rx_ctrl;
+
+    // Data channel CTRL values (8-bit frames), with and without address increment
+    uint32_t ctrl_tx_incr, ctrl_tx_fixed;
+    uint32_t ctrl_rx_incr, ctrl_rx_fixed;
+
+    spin_lock_t* lock;
+    volatile bool busy;
+    const spi_device_t* active;
+    spi_device_callback_t callback;
+    void* ctx;
+    bool initialized;
+} spi_bus_t;
+
+static spi_bus_t spi_buses[NUM_SPIS];
+static bool spi_irq_installed = false;
+
+static const uint16_t spi_fill = 0xFFFF;
+static uint16_t spi_discard;
+
+static void spi_dma_irq_handler(void) {
+    for (uint i = 0; i < NUM_SPIS; i++) {
+        spi_bus_t* bus = &spi_buses[i];
+        if (!bus->initialized || !dma_irqn_get_channel_status(1, bus->dma_rx)) continue;
+
+        dma_irqn_acknowledge_channel(1, bus->dma_rx);
+        const spi_device_t* dev = bus->active;
+        gpio_put(dev->cs_pin, 1);
+
+        spi_device_callback_t callback = bus->callback;
+        void* ctx = bus->ctx;
+        bus->active = NULL;
+        bus->busy = false;
+        __sev();
+
+        if (callback) callback(dev, ctx);
+    }
+}
+
+static uint32_t spi_data_ctrl(uint channel, uint chain_to, uint dreq, bool read_incr, bool write_incr) {
+    dma_channel_config c = dma_channel_get_default_config(channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_dreq(&c, dreq);
+    channel_config_set_chain_to(&c, chain_to);
+    channel_config_set_irq_quiet(&c, true);
+    channel_config_set_read_increment(&c, read_incr);
+    channel_config_set_write_increment(&c, write_incr);
+    return channel_config_get_ctrl_value(&c);
+}
+
+static void spi_ctrl_channel_init(uint ctrl_channel, uint data_channel, spi_dma_block_t* blocks) {
+    dma_channel_config c = dma_channel_get_default_config(ctrl_channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, 4);  // Wrap the write address every 16 bytes (one block)
+    dma_channel_configure(ctrl_channel, &c, &dma_hw->ch[data_channel].al1_ctrl, blocks, 4, false);
+}
+
+void spi_bus_init(spi_inst_t* spi, uint sck, uint mosi, uint miso) {
+    spi_bus_t* bus = &spi_buses[spi_get_index(spi)];
+
+    gpio_set_function(sck,  GPIO_FUNC_SPI);
+    gpio_set_function(mosi, GPIO_FUNC_SPI);
+    gpio_set_function(miso, GPIO_FUNC_SPI);
+
+    // Resets the block and enables the TX/RX DMA requests
+    spi_init(spi, 1000000);
+    bus->cr0 = spi_get_hw(spi)->cr0;
+    bus->cpsr = spi_get_hw(spi)->cpsr;
+
+    bus->dma_tx = dma_claim_unused_channel(true);
+    bus->dma_rx = dma_claim_unused_channel(true);
+    bus->dma_tx_ctrl = dma_claim_unused_channel(true);
+    bus->dma_rx_ctrl = dma_claim_unused_channel(true);
+
+    uint dreq_tx = spi_get_dreq(spi, true);
+    uint dreq_rx = spi_get_dreq(spi, false);
+    bus->ctrl_tx_incr  = spi_data_ctrl(bus->dma_tx, bus->dma_tx_ctrl, dreq_tx, true,  false);
+    bus->ctrl_tx_fixed = spi_data_ctrl(bus->dma_tx, bus->dma_tx_ctrl, dreq_tx, false, false);
+    bus->ctrl_rx_incr  = spi_data_ctrl(bus->dma_rx, bus->dma_rx_ctrl, dreq_rx, false, true);
+    bus->ctrl_rx_fixed = spi_data_ctrl(bus->dma_rx, bus->dma_rx_ctrl, dreq_rx, false, false);
+
+    spi_ctrl_channel_init(bus->dma_tx_ctrl, bus->dma_tx, bus->tx_blocks);
+    spi_ctrl_channel_init(bus->dma_rx_ctrl, bus->dma_rx, bus->rx_blocks);
+
+    bus->lock = spin_lock_instance(spin_lock_claim_unused(true));
+    bus->busy = false;
+    bus->active = NULL;
+
+    dma_irqn_set_channel_enabled(1, bus->dma_rx, true);
+    if (!spi_irq_installed) {
+        irq_add_shared_handler(DMA_IRQ_1, spi_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_1, true);
+        spi_irq_installed = true;
+    }
+    bus->initialized = true;
+}
+
+void spi_device_init(spi_device_t* dev, spi_inst_t* spi, uint cs_pin, uint32_t baud, uint8_t mode, uint8_t data_bits) {
+    uint32_t cpsr, scr;
+    spi_compute_divisors(clock_get_hz(clk_peri), baud, &cpsr, &scr);
+
+    dev->spi = spi;
+    dev->cs_pin = cs_pin;
+    dev->baud = baud;
+    dev->mode = mode & 3u;
+    dev->data_bits = data_bits;
+    dev->cpsr = cpsr;
+    dev->cr0 = ((uint32_t)(data_bits - 1) << SPI_SSPCR0_DSS_LSB) |
+               ((uint32_t)(mode >> 1 & 1u) << SPI_SSPCR0_SPO_LSB) |
+               ((uint32_t)(mode & 1u) << SPI_SSPCR0_SPH_LSB) |
+               (scr << SPI_SSPCR0_SCR_LSB);
+
+    gpio_init(cs_pin);
+    gpio_put(cs_pin, 1);
+    gpio_set_dir(cs_pin, GPIO_OUT);
+}
+
+// Wait until the bus is idle and mark it busy
+static void spi_bus_claim(spi_bus_t* bus) {
+    for (;;) {
+        uint32_t irq = spin_lock_blocking(bus->lock);
+        bool claimed = !bus->busy;
+        if (claimed) bus->busy = true;
+        spin_unlock(bus->lock, irq);
+        if (claimed) return;
+        __wfe();
+    }
+}
+
+// Load only the registers that differ from the previous device
+static void spi_bus_apply(spi_bus_t* bus, const spi_device_t* dev) {
+    if (bus->cr0 == dev->cr0 && bus->cpsr == dev->cpsr) return;
+
+    spi_hw_t* hw = spi_get_hw(dev->spi);
+    hw_clear_bits(&hw->cr1, SPI_SSPCR1_SSE_BITS);
+    if (bus->cpsr != dev->cpsr) {
+        hw->cpsr = dev->cpsr;
+        bus->cpsr = dev->cpsr;
+    }
+    if (bus->cr0 != dev->cr0) {
+        hw->cr0 = dev->cr0;
+        bus->cr0 = dev->cr0;
+    }
+    hw_set_bits(&hw->cr1, SPI_SSPCR1_SSE_BITS);
+}
+
+static inline uint32_t spi_ctrl_sized(uint32_t ctrl, bool wide) {
+    return wide ? (ctrl & ~DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) | ((uint32_t)DMA_SIZE_16 << DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB)
+                : ctrl;
+}
+
+bool spi_device_transfer_async(const spi_device_t* dev, const spi_segment_t* segs, uint count,
+                               spi_device_callback_t callback, void* ctx) {
+    if (!dev || !segs || count == 0 || count > SPI_DEVICE_MAX_SEGMENTS) return false;
+    spi_bus_t* bus = &spi_buses[spi_get_index(dev->spi)];
+    if (!bus->initialized) return false;
+
+    // With no frames there would be no DMA interrupt to run the callback from
+    bool has_frames = false;
+    for (uint i = 0; i < count; i++) has_frames |= segs[i].len != 0;
+    if (!has_frames) return false;
+
+    spi_bus_claim(bus);
+    spi_bus_apply(bus, dev);
+
+    spi_hw_t* hw = spi_get_hw(dev->spi);
+    bool wide = dev->data_bits > 8;
+    uint32_t tx_incr = spi_ctrl_sized(bus->ctrl_tx_incr, wide), tx_fixed = spi_ctrl_sized(bus->ctrl_tx_fixed, wide);
+    uint32_t rx_incr = spi_ctrl_sized(bus->ctrl_rx_incr, wide), rx_fixed = spi_ctrl_sized(bus->ctrl_rx_fixed, wide);
+
+    // A zero count would be taken as the terminating null trigger, so skip empty segments
+    uint n = 0;
+    for (uint i = 0; i < count; i++) {
+        const spi_segment_t* s = &segs[i];
+        if (s->len == 0) continue;
+        bus->tx_blocks[n] = (spi_dma_block_t){
+            s->tx ? tx_incr : tx_fixed, s->tx ? s->tx : &spi_fill, &hw->dr, s->len };
+        bus->rx_blocks[n] = (spi_dma_block_t){
+            s->rx ? rx_incr : rx_fixed, &hw->dr, s->rx ? s->rx : &spi_discard, s->len };
+        n++;
+    }
+    bus->tx_blocks[n] = (spi_dma_block_t){ tx_fixed, NULL, NULL, 0 };
+    bus->rx_blocks[n] = (spi_dma_block_t){ rx_fixed, NULL, NULL, 0 };
+
+    bus->active = dev;
+    bus->callback = callback;
+    bus->ctx = ctx;
+
+    // Drop stale RX data, then start both chains together
+    while (spi_is_readable(dev->spi)) (void)hw->dr;
+    gpio_put(dev->cs_pin, 0);
+    dma_channel_set_read_addr(bus->dma_rx_ctrl, bus->rx_blocks, false);
+    dma_channel_set_read_addr(bus->dma_tx_ctrl, bus->tx_blocks, false);
+    dma_start_channel_mask((1u << bus->dma_rx_ctrl) | (1u << bus->dma_tx_ctrl));
+    return true;
+}
+
+bool spi_device_transfer(const spi_device_t* dev, const spi_segment_t* segs, uint count) {
+    if (!spi_device_transfer_async(dev, segs, count, NULL, NULL)) return false;
+    while (spi_device_busy(dev)) __wfe();
+    return true;
+}
+
+bool spi_device_busy(const spi_device_t* dev) {
+    return spi_buses[spi_get_index(dev->spi)].busy;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "hardware/spi.h"
+#include "hardware/gpio.h"
+#include "hardware/clocks.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Maximum number of segments in one transaction
+#ifndef SPI_DEVICE_MAX_SEGMENTS
+#define SPI_DEVICE_MAX_SEGMENTS 8
+#endif
+
+/**
+ * @struct spi_device_t
+ * @brief Descriptor for one device on a shared SPI bus.
+ *
+ * spi        – SPI instance the device is wired to
+ * cs_pin     – chip-select GPIO (active low, driven by the driver)
+ * baud       – requested SCK frequency in Hz
+ * mode       – SPI mode 0-3 (bit 1 = CPOL, bit 0 = CPHA)
+ * data_bits  – frame size, 4-16 bits
+ * cr0, cpsr  – precomputed SSPCR0/SSPCPSR register image
+ */
+typedef struct {
+    spi_inst_t* spi;
+    uint     cs_pin;
+    uint32_t baud;
+    uint8_t  mode;
+    uint8_t  data_bits;
+    uint32_t cr0;
+    uint32_t cpsr;
+} spi_device_t;
+
+/**
+ * @struct spi_segment_t
+ * @brief One piece of a transaction (e.g. command, address or data phase).
+ *
+ * tx   – frames to send, or NULL to clock out 0xFF filler
+ * rx   – buffer for received frames, or NULL to discard them
+ * len  – number of frames (bytes for 8-bit devices, halfwords above 8 bits)
+ */
+typedef struct {
+    const void* tx;
+    void*       rx;
+    uint32_t    len;
+} spi_segment_t;
+
+/// Completion callback for asynchronous transactions (runs in DMA IRQ context)
+typedef void (*spi_device_callback_t)(const spi_device_t* dev, void* ctx);
+
+/**
+ * @brief Compute the PL022 prescaler and serial clock rate for a baud rate.
+ *
+ * Picks the smallest even prescaler (2-254) that can reach the rate, then the
+ * largest SCR that does not exceed it.
+ *
+ * @param clk_peri Peripheral clock in Hz.
+ * @param baud Requested SCK frequency in Hz.
+ * @param cpsr Output: SSPCPSR value.
+ * @param scr Output: SCR field of SSPCR0.
+ * @return Actual SCK frequency in Hz.
+ */
+uint32_t spi_compute_divisors(uint32_t clk_peri, uint32_t baud, uint32_t* cpsr, uint32_t* scr);
+
+/**
+ * @brief Bring up an SPI bus and claim its DMA channels.
+ * @param spi SPI instance.
+ * @param sck GPIO pin for SCK.
+ * @param mosi GPIO pin for MOSI.
+ * @param miso GPIO pin for MISO.
+ */
+void spi_bus_init(spi_inst_t* spi, uint sck, uint mosi, uint miso);
+
+/**
+ * @brief Describe a device and precompute its register settings.
+ *
+ * Also configures the chip-select pin as an output, deasserted.
+ *
+ * @param dev Descriptor to fill.
+ * @param spi SPI instance (must have been passed to spi_bus_init()).
+ * @param cs_pin Chip-select GPIO.
+ * @param baud SCK frequency in Hz.
+ * @param mode SPI mode 0-3.
+ * @param data_bits Frame size, 4-16 bits.
+ */
+void spi_device_init(spi_device_t* dev, spi_inst_t* spi, uint cs_pin, uint32_t baud, uint8_t mode, uint8_t data_bits);
+
+/**
+ * @brief Start a transaction without blocking.
+ *
+ * Waits for the bus to be free, applies only the register settings that
+ * differ from the previous device, asserts CS, and runs all segments
+ * back-to-back through chained DMA. CS is released and the callback invoked
+ * from the DMA interrupt when the last frame has been received. The callback
+ * never runs before this function returns.
+ *
+ * @param dev Device to talk to.
+ * @param segs Segment list (copied; may be reused after return).
+ * @param count Number of segments (1..SPI_DEVICE_MAX_SEGMENTS).
+ * @param callback Completion callback, or NULL.
+ * @param ctx Passed to the callback.
+ * @return true if started, false on invalid arguments or if every segment
+ *         is empty (the callback is then not called).
+ */
+bool spi_device_transfer_async(const spi_device_t* dev, const spi_segment_t* segs, uint count,
+                               spi_device_callback_t callback, void* ctx);
+
+/**
+ * @brief Run a transaction and wait for it to complete.
+ * @return true on success, false on invalid arguments or an all-empty segment list.
+ */
+bool spi_device_transfer(const spi_device_t* dev, const spi_segment_t* segs, uint count);
+
+/**
+ * @brief Query whether the bus of a device is running a transaction.
+ */
+bool spi_device_busy(const spi_device_t* dev);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,22 @@
+#include "spi_device.h"
+
+// Shared by spi_device.c and the register backend. It touches no hardware,
+// so the host test in host/ builds it as is.
+
+uint32_t spi_compute_divisors(uint32_t clk_peri, uint32_t baud, uint32_t* cpsr, uint32_t* scr) {
+    uint32_t prescale, postdiv;
+
+    // Smallest even prescaler for which the largest post-divide can still reach the rate
+    for (prescale = 2; prescale < 254; prescale += 2) {
+        if ((uint64_t)clk_peri <= (uint64_t)prescale * 256u * baud) break;
+    }
+
+    // Largest post-divide (SCR + 1) that does not exceed the requested rate
+    for (postdiv = 256; postdiv > 1; --postdiv) {
+        if (clk_peri / (prescale * (postdiv - 1)) > baud) break;
+    }
+
+    *cpsr = prescale;
+    *scr = postdiv - 1;
+    return clk_peri / (prescale * postdiv);
+}
@@ -1,8 +1,10 @@
-#include "hardware/spi.h"
-#include "hardware/gpio.h"
-#include "hardware/clocks.h"
+#include "spi_driver.h"
 
-static inline void SPI_begin(uint32_t baud, uint sck, uint mosi, uint miso) {
+static uint spi_data_bits = 8;
+static spi_cpol_t spi_cpol = SPI_CPOL_0;
+static spi_cpha_t spi_cpha = SPI_CPHA_0;
+
+void SPI_begin(uint32_t baud, uint sck, uint mosi, uint miso) {
     // --- Step 1: Configure GPIO functions ---
     gpio_set_function(sck,  GPIO_FUNC_SPI);
     gpio_set_function(mosi, GPIO_FUNC_SPI);
@@ -12,6 +14,9 @@ static inline void SPI_begin(uint32_t baud, uint sck, uint mosi, uint miso) {
     spi_init(spi0, baud);
 
     // --- Step 3: Set default format (8 bits, CPOL=0, CPHA=0, MSB first) ---
+    spi_data_bits = 8;
+    spi_cpol = SPI_CPOL_0;
+    spi_cpha = SPI_CPHA_0;
     spi_set_format(spi0,
                    8,      // bits per transfer
                    SPI_CPOL_0,
@@ -19,30 +24,55 @@ static inline void SPI_begin(uint32_t baud, uint sck, uint mosi, uint miso) {
                    SPI_MSB_FIRST);
 }
 
-static inline uint8_t SPI_transfer(uint8_t data) {
+uint8_t SPI_transfer(uint8_t data) {
     uint8_t rx;
     spi_write_read_blocking(spi0, &data, &rx, 1);
     return rx;
 }
 
-static inline void SPI_transferBytes(const uint8_t *tx, uint8_t *rx, size_t len) {
+uint16_t SPI_transfer16(uint16_t data) {
+    uint16_t rx;
+    spi_write16_read16_blocking(spi0, &data, &rx, 1);
+    return rx;
+}
+
+void SPI_transferBytes(const uint8_t *tx, uint8_t *rx, size_t len) {
     spi_write_read_blocking(spi0, tx, rx, len);
 }
 
-static inline void SPI_beginTransaction(uint32_t baud, uint cpol, uint cpha) {
+void SPI_transferWords(const uint16_t *tx, uint16_t *rx, size_t len) {
+    spi_write16_read16_blocking(spi0, tx, rx, len);
+}
+
+void SPI_writeBytes(const uint8_t *tx, size_t len) {
+    spi_write_blocking(spi0, tx, len);
+}
+
+void SPI_writeWords(const uint16_t *tx, size_t len) {
+    spi_write16_blocking(spi0, tx, len);
+}
+
+void SPI_setDataBits(uint bits) {
+    spi_data_bits = bits < 4 ? 4 : bits > 16 ? 16 : bits;
+    spi_set_format(spi0, spi_data_bits, spi_cpol, spi_cpha, SPI_MSB_FIRST);
+}
+
+void SPI_beginTransaction(uint32_t baud, uint cpol, uint cpha) {
+    spi_cpol = cpol ? SPI_CPOL_1 : SPI_CPOL_0;
+    spi_cpha = cpha ? SPI_CPHA_1 : SPI_CPHA_0;
     spi_set_baudrate(spi0, baud);
-    spi_set_format(spi0,
-                   8,
-                   cpol ? SPI_CPOL_1 : SPI_CPOL_0,
-                   cpha ? SPI_CPHA_1 : SPI_CPHA_0,
-                   SPI_MSB_FIRST);
+    spi_set_format(spi0, spi_data_bits, spi_cpol, spi_cpha, SPI_MSB_FIRST);
 }
 
-static inline void SPI_endTransaction(void) {
+void SPI_endTransaction(void) {
     // No-op: SDK handles state internally
 }
 
-static inline void SPI_transferDMA(const uint8_t *tx, uint8_t *rx, size_t len) {
+void SPI_clockChanged(void) {
+    // No-op: spi_set_baudrate() reads clk_peri from the SDK on every call
+}
+
+void SPI_transferDMA(const uint8_t *tx, uint8_t *rx, size_t len) {
     // Blocking fallback
     spi_write_read_blocking(spi0, tx, rx, len);
 }
\ No newline at end of file
@@ -16,14 +16,21 @@ extern "C" {
  * @param mosi GPIO pin for MOSI.
  * @param miso GPIO pin for MISO.
  */
-static inline __attribute__((always_inline)) void SPI_begin(uint32_t baud, uint sck, uint mosi, uint miso);
+void SPI_begin(uint32_t baud, uint sck, uint mosi, uint miso);
 
 /**
  * @brief Transfers a byte over SPI and returns the received byte.
  * @param data Byte to send.
  * @return Byte received.
  */
-static inline __attribute__((always_inline)) uint8_t SPI_transfer(uint8_t data);
+uint8_t SPI_transfer(uint8_t data);
+
+/**
+ * @brief Transfers one 9-16 bit frame and returns the received frame.
+ * @param data Frame to send (set the frame size with SPI_setDataBits()).
+ * @return Frame received.
+ */
+uint16_t SPI_transfer16(uint16_t data);
 
 /**
  * @brief Transfer multiple bytes over SPI.
@@ -34,7 +41,41 @@ static inline __attribute__((always_inline)) uint8_t SPI_transfer(uint8_t data);
  * @param rx Pointer to receive buffer.
  * @param len Number of bytes to transfer.
  */
-static inline __attribute__((always_inline)) void SPI_transferBytes(const uint8_t *tx, uint8_t *rx, size_t len);
+void SPI_transferBytes(const uint8_t *tx, uint8_t *rx, size_t len);
+
+/**
+ * @brief Transfer multiple 9-16 bit frames over SPI (blocking).
+ *
+ * @param tx Pointer to transmit frames.
+ * @param rx Pointer to receive frames.
+ * @param len Number of frames to transfer.
+ */
+void SPI_transferWords(const uint16_t *tx, uint16_t *rx, size_t len);
+
+/**
+ * @brief Send bytes without reading them back (blocking).
+ *
+ * Received data is discarded once at the end of the burst.
+ *
+ * @param tx Pointer to transmit buffer.
+ * @param len Number of bytes to send.
+ */
+void SPI_writeBytes(const uint8_t *tx, size_t len);
+
+/**
+ * @brief Send 9-16 bit frames without reading them back (blocking).
+ *
+ * @param tx Pointer to transmit frames.
+ * @param len Number of frames to send.
+ */
+void SPI_writeWords(const uint16_t *tx, size_t len);
+
+/**
+ * @brief Set the frame size.
+ *
+ * @param bits Bits per frame, 4-16 (clamped).
+ */
+void SPI_setDataBits(uint bits);
 
 /**
  * @brief Begin an SPI transaction with custom format.
@@ -45,14 +86,24 @@ static inline __attribute__((always_inline)) void SPI_transferBytes(const uint8_
  * @param cpol Clock polarity (0 or 1).
  * @param cpha Clock phase (0 or 1).
  */
-static inline __attribute__((always_inline)) void SPI_beginTransaction(uint32_t baud, uint cpol, uint cpha);
+void SPI_beginTransaction(uint32_t baud, uint cpol, uint cpha);
 
 /**
  * @brief End an SPI transaction.
  *
  * Currently a no-op, included for API symmetry.
  */
-static inline __attribute__((always_inline)) void SPI_endTransaction(void);
+void SPI_endTransaction(void);
+
+/**
+ * @brief Pick up a new clk_peri frequency.
+ *
+ * The register backend measures clk_peri once and reuses it for every
+ * baud calculation. Call this after clk_peri changes (for example from the
+ * idle governor's clock-restore hook); the new frequency applies from the
+ * next SPI_begin() or SPI_beginTransaction().
+ */
+void SPI_clockChanged(void);
 
 /**
  * @brief Transfer multiple bytes using DMA (blocking).
@@ -63,7 +114,7 @@ static inline __attribute__((always_inline)) void SPI_endTransaction(void);
  * @param rx Pointer to receive buffer.
  * @param len Number of bytes to transfer.
  */
-static inline __attribute__((always_inline)) void SPI_transferDMA(const uint8_t *tx, uint8_t *rx, size_t len);
+void SPI_transferDMA(const uint8_t *tx, uint8_t *rx, size_t len);
 
 
 #ifdef __cplusplus
@@ -0,0 +1,162 @@
+#include "spi_driver.h"
+#include "spi_device.h"  // spi_compute_divisors()
+
+#include "hardware/address_mapped.h"
+#include "hardware/clocks.h"
+
+#include "hardware/regs/clocks.h"
+#include "hardware/regs/pads_bank0.h"
+
+#include "hardware/structs/spi.h"
+#include "hardware/structs/io_bank0.h"
+#include "hardware/structs/resets.h"
+#include "hardware/structs/pads_bank0.h"
+
+#define IO_BANK0_GPIO_CTRL_FUNCSEL_VALUE_SPI 0x01u  // FUNCSEL 1 selects SPI on every bank-0 pin
+#define SPI_FIFO_DEPTH 8u                           // PL022 TX and RX FIFOs are 8 frames deep
+
+static uint32_t spi_clk_peri_hz = 0;
+static uint32_t spi_data_bits = 8;
+
+// clk_peri as measured by the frequency counter (1 kHz resolution). A
+// measurement takes about a millisecond, so it is kept until SPI_begin() or
+// SPI_clockChanged() drops it.
+static inline uint32_t get_clk_peri_freq(void) {
+    if (spi_clk_peri_hz == 0)
+        spi_clk_peri_hz = frequency_count_khz(CLOCKS_FC0_SRC_VALUE_CLK_PERI) * 1000u;
+    return spi_clk_peri_hz;
+}
+
+// Reload CR0 (format, SCR) and CPSR with the peripheral disabled
+static inline void spi_regs_configure(uint32_t baud, uint cpol, uint cpha) {
+    uint32_t cpsr, scr;
+    spi_compute_divisors(get_clk_peri_freq(), baud, &cpsr, &scr);
+
+    spi0_hw->cr1 = 0;
+    spi0_hw->cpsr = cpsr;
+    spi0_hw->cr0 = ((spi_data_bits - 1) << SPI_SSPCR0_DSS_LSB) |
+                   ((cpol & 1) << SPI_SSPCR0_SPO_LSB) |
+                   ((cpha & 1) << SPI_SSPCR0_SPH_LSB) |
+                   (scr << SPI_SSPCR0_SCR_LSB);
+    spi0_hw->cr1 = SPI_SSPCR1_SSE_BITS;
+}
+
+// Wait for the shifter to go idle, then discard RX frames left by TX-only bursts
+static inline void spi_regs_flush_rx(void) {
+    while (spi0_hw->sr & SPI_SSPSR_BSY_BITS) {}
+    while (spi0_hw->sr & SPI_SSPSR_RNE_BITS) (void)spi0_hw->dr;
+    spi0_hw->icr = SPI_SSPICR_RORIC_BITS;
+}
+
+void SPI_begin(uint32_t target_baud, uint sck, uint mosi, uint miso) {
+    // --- Step 1: Cycle SPI0 through reset ---
+    hw_set_bits(&resets_hw->reset, RESETS_RESET_SPI0_BITS);
+    hw_clear_bits(&resets_hw->reset, RESETS_RESET_SPI0_BITS);
+    while (!(resets_hw->reset_done & RESETS_RESET_DONE_SPI0_BITS)) {}
+
+    // --- Step 2: Configure GPIO functions ---
+    io_bank0_hw->io[sck].ctrl  = IO_BANK0_GPIO_CTRL_FUNCSEL_VALUE_SPI;
+    io_bank0_hw->io[mosi].ctrl = IO_BANK0_GPIO_CTRL_FUNCSEL_VALUE_SPI;
+    io_bank0_hw->io[miso].ctrl = IO_BANK0_GPIO_CTRL_FUNCSEL_VALUE_SPI;
+
+    // --- Step 3: Disable pulls, enable the MISO input buffer ---
+    hw_clear_bits(&pads_bank0_hw->io[sck],  PADS_BANK0_GPIO0_PUE_BITS | PADS_BANK0_GPIO0_PDE_BITS);
+    hw_clear_bits(&pads_bank0_hw->io[mosi], PADS_BANK0_GPIO0_PUE_BITS | PADS_BANK0_GPIO0_PDE_BITS);
+    hw_clear_bits(&pads_bank0_hw->io[miso], PADS_BANK0_GPIO0_PUE_BITS | PADS_BANK0_GPIO0_PDE_BITS);
+    hw_set_bits(&pads_bank0_hw->io[miso], PADS_BANK0_GPIO0_IE_BITS);
+
+    // --- Step 4: 8-bit Motorola mode 0, prescaler/SCR from a fresh clk_peri, enable ---
+    spi_clk_peri_hz = 0;
+    spi_data_bits = 8;
+    spi_regs_configure(target_baud, 0, 0);
+}
+
+uint8_t SPI_transfer(uint8_t data) {
+    while (!(spi0_hw->sr & SPI_SSPSR_TNF_BITS)) {}
+    spi0_hw->dr = data;
+    while (!(spi0_hw->sr & SPI_SSPSR_RNE_BITS)) {}
+    return (uint8_t)spi0_hw->dr;
+}
+
+uint16_t SPI_transfer16(uint16_t data) {
+    while (!(spi0_hw->sr & SPI_SSPSR_TNF_BITS)) {}
+    spi0_hw->dr = data;
+    while (!(spi0_hw->sr & SPI_SSPSR_RNE_BITS)) {}
+    return (uint16_t)spi0_hw->dr;
+}
+
+// Keep the TX FIFO topped up while draining RX; never more than
+// SPI_FIFO_DEPTH frames in flight, so the RX FIFO cannot overrun.
+void SPI_transferBytes(const uint8_t *tx, uint8_t *rx, size_t len) {
+    size_t tx_left = len, rx_left = len;
+    while (rx_left) {
+        if (tx_left && rx_left - tx_left < SPI_FIFO_DEPTH && (spi0_hw->sr & SPI_SSPSR_TNF_BITS)) {
+            spi0_hw->dr = *tx++;
+            --tx_left;
+        }
+        if (spi0_hw->sr & SPI_SSPSR_RNE_BITS) {
+            *rx++ = (uint8_t)spi0_hw->dr;
+            --rx_left;
+        }
+    }
+}
+
+void SPI_transferWords(const uint16_t *tx, uint16_t *rx, size_t len) {
+    size_t tx_left = len, rx_left = len;
+    while (rx_left) {
+        if (tx_left && rx_left - tx_left < SPI_FIFO_DEPTH && (spi0_hw->sr & SPI_SSPSR_TNF_BITS)) {
+            spi0_hw->dr = *tx++;
+            --tx_left;
+        }
+        if (spi0_hw->sr & SPI_SSPSR_RNE_BITS) {
+            *rx++ = (uint16_t)spi0_hw->dr;
+            --rx_left;
+        }
+    }
+}
+
+// TX-only: fill the FIFO as fast as it drains, flush RX once at the end
+void SPI_writeBytes(const uint8_t *tx, size_t len) {
+    while (len) {
+        if (spi0_hw->sr & SPI_SSPSR_TNF_BITS) {
+            spi0_hw->dr = *tx++;
+            --len;
+        }
+    }
+    spi_regs_flush_rx();
+}
+
+void SPI_writeWords(const uint16_t *tx, size_t len) {
+    while (len) {
+        if (spi0_hw->sr & SPI_SSPSR_TNF_BITS) {
+            spi0_hw->dr = *tx++;
+            --len;
+        }
+    }
+    spi_regs_flush_rx();
+}
+
+void SPI_setDataBits(uint bits) {
+    bits = bits < 4 ? 4 : bits > 16 ? 16 : bits;
+    spi_data_bits = bits;
+    spi0_hw->cr1 = 0;
+    spi0_hw->cr0 = (spi0_hw->cr0 & ~SPI_SSPCR0_DSS_BITS) | ((bits - 1) << SPI_SSPCR0_DSS_LSB);
+    spi0_hw->cr1 = SPI_SSPCR1_SSE_BITS;
+}
+
+void SPI_beginTransaction(uint32_t baud, uint cpol, uint cpha) {
+    spi_regs_configure(baud, cpol, cpha);
+}
+
+void SPI_endTransaction(void) {
+    // No-op
+}
+
+void SPI_clockChanged(void) {
+    spi_clk_peri_hz = 0;
+}
+
+void SPI_transferDMA(const uint8_t *tx, uint8_t *rx, size_t len) {
+    // Blocking fallback
+    SPI_transferBytes(tx, rx, len);
+}
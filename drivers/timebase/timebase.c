@@ -0,0 +1,63 @@
+#include "timebase.h"
+
+timebase_calib_t timebase_calib = {
+    .sys_hz            = RP2040_SYSCLK_HZ,
+    .cycles_per_us_q16 = TIMEBASE_CYCLES_PER_US_Q16(RP2040_SYSCLK_HZ),
+    .cycles_per_ns_q32 = TIMEBASE_CYCLES_PER_NS_Q32(RP2040_SYSCLK_HZ),
+    .us_per_cycle_q32  = TIMEBASE_US_PER_CYCLE_Q32(RP2040_SYSCLK_HZ),
+};
+
+// Call, loop setup and return overhead of timebase_delay_cycles() in cycles
+#define TIMEBASE_SPIN_OVERHEAD 12u
+
+uint32_t timebase_calibrate(void) {
+    // The frequency counter resolves to 1 kHz; prefer the configured value
+    // when the measurement agrees with it, so integer-MHz clocks stay exact.
+    uint32_t measured = frequency_count_khz(CLOCKS_FC0_SRC_VALUE_CLK_SYS) * 1000u;
+    uint32_t configured = clock_get_hz(clk_sys);
+    uint32_t diff = measured > configured ? measured - configured : configured - measured;
+    uint32_t hz = diff <= 2000u ? configured : measured;
+
+    // Division is fine here: this runs once per clock change, not per conversion
+    timebase_calib.sys_hz            = hz;
+    timebase_calib.cycles_per_us_q16 = TIMEBASE_CYCLES_PER_US_Q16(hz);
+    timebase_calib.cycles_per_ns_q32 = TIMEBASE_CYCLES_PER_NS_Q32(hz);
+    timebase_calib.us_per_cycle_q32  = TIMEBASE_US_PER_CYCLE_Q32(hz);
+    return hz;
+}
+
+// `loops` passes of a 3-cycle loop (SUBS = 1, taken BNE = 2; the last, untaken BNE is 1) from SRAM
+static void __not_in_flash_func(timebase_spin)(uint32_t loops) {
+    if (loops == 0) return;
+    __asm volatile (
+        "1: subs %0, %0, #1\n"
+        "   bne 1b\n"
+        : "+l"(loops)
+        :
+        : "cc"
+    );
+}
+
+void __not_in_flash_func(timebase_delay_cycles)(uint32_t cycles) {
+    // Long waits go through the timer so interrupts cannot stretch them
+    // arbitrarily; only the sub-microsecond remainder is spun. The timer read
+    // lands anywhere inside its current microsecond, so waiting for one extra
+    // tick keeps the delay from ending early: it runs up to 1 us long instead.
+    uint32_t spin_max = TIMEBASE_SPIN_MAX_US * (timebase_calib.cycles_per_us_q16 >> 16);
+    if (cycles > spin_max) {
+        uint32_t us = timebase_cycles_to_us(cycles);
+        uint64_t target = timebase_now_us() + us + 1;
+        cycles -= (uint32_t)timebase_us_to_cycles(us);
+        while (timebase_now_us() < target) __asm volatile("nop");
+    }
+
+    if (cycles <= TIMEBASE_SPIN_OVERHEAD) return;
+    cycles -= TIMEBASE_SPIN_OVERHEAD;
+
+    // loops = cycles / 3 without a runtime divide: multiply by 2^16/3
+    timebase_spin((cycles * 21846u) >> 16);
+}
+
+void timebase_delay_ns(uint32_t ns) {
+    timebase_delay_cycles(timebase_ns_to_cycles(ns));
+}
@@ -0,0 +1,147 @@
+#pragma once
+/**
+ * @file timebase.h
+ * @brief 64-bit monotonic timebase, calibrated cycle delays (3-cycle resolution up to
+ *        TIMEBASE_SPIN_MAX_US, 1 us beyond) and time conversions.
+ *
+ * All conversions use fixed-point multipliers (calibrated once against the
+ * measured clk_sys) or compile-time constant math, so no runtime division is
+ * performed on the hot path.
+ */
+
+#include "hardware/structs/timer.h"
+#include "hardware/structs/systick.h"
+#include "hardware/clocks.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ─────────────────────────────────────────────────────────────
+// Nominal system clock frequency (in Hz)
+// Used for compile-time conversions and as the pre-calibration default.
+// Override this macro before including if using a custom clock.
+#ifndef RP2040_SYSCLK_HZ
+#define RP2040_SYSCLK_HZ 125000000u  // Default 125 MHz
+#endif
+
+// ─────────────────────────────────────────────────────────────
+// Compile-time conversions (folded by the compiler for constant arguments)
+#define TIMEBASE_US_TO_CYCLES_CONST(us)  ((uint32_t)(((uint64_t)(us) * RP2040_SYSCLK_HZ) / 1000000u))
+#define TIMEBASE_NS_TO_CYCLES_CONST(ns)  ((uint32_t)(((uint64_t)(ns) * RP2040_SYSCLK_HZ) / 1000000000u))
+
+// Fixed-point multipliers for a given clk_sys frequency
+#define TIMEBASE_CYCLES_PER_US_Q16(hz)   ((uint32_t)(((uint64_t)(hz) << 16) / 1000000u))
+#define TIMEBASE_CYCLES_PER_NS_Q32(hz)   ((uint32_t)(((uint64_t)(hz) << 32) / 1000000000u))
+#define TIMEBASE_US_PER_CYCLE_Q32(hz)    ((uint32_t)((1000000ull << 32) / (hz)))
+
+// Delays up to this are spun (3-cycle resolution), longer ones poll the timer (1 us resolution)
+#ifndef TIMEBASE_SPIN_MAX_US
+#define TIMEBASE_SPIN_MAX_US 8u
+#endif
+
+/**
+ * @struct timebase_calib_t
+ * @brief Fixed-point conversion factors derived from the measured clk_sys.
+ *
+ * sys_hz             – clk_sys frequency in Hz
+ * cycles_per_us_q16  – clk_sys / 1e6 in Q16.16
+ * cycles_per_ns_q32  – clk_sys / 1e9 in Q0.32
+ * us_per_cycle_q32   – 1e6 / clk_sys in Q0.32
+ */
+typedef struct {
+    uint32_t sys_hz;
+    uint32_t cycles_per_us_q16;
+    uint32_t cycles_per_ns_q32;
+    uint32_t us_per_cycle_q32;
+} timebase_calib_t;
+
+/// Active conversion factors (initialized to RP2040_SYSCLK_HZ until calibrated)
+extern timebase_calib_t timebase_calib;
+
+/**
+ * @brief Measure clk_sys with the frequency counter and refresh the conversion factors.
+ *
+ * Call once after clocks are configured, and again whenever clk_sys changes
+ * (e.g. after waking from dormant).
+ *
+ * @return Calibrated clk_sys frequency in Hz.
+ */
+uint32_t timebase_calibrate(void);
+
+/**
+ * @brief Busy-wait for at least a number of clk_sys cycles.
+ *
+ * Runs from SRAM so XIP cache misses cannot stretch the loop. Up to
+ * TIMEBASE_SPIN_MAX_US the wait is spun and resolves to 3 cycles. Longer
+ * waits poll the 1 us timer and then spin the remainder. They never end
+ * early and may run up to 1 us long. Interrupts taken during the wait
+ * extend it.
+ *
+ * @param cycles Number of CPU cycles to wait.
+ */
+void timebase_delay_cycles(uint32_t cycles);
+
+/**
+ * @brief Busy-wait for a number of nanoseconds using the calibrated clock.
+ * @param ns Nanoseconds to wait.
+ */
+void timebase_delay_ns(uint32_t ns);
+
+// ─────────────────────────────────────────────────────────────
+// 64-bit monotonic time in microseconds.
+// Reads TIMERAWH/TIMERAWL/TIMERAWH and retries if the high word moved, so the
+// result never tears across a low-word rollover. The latched TIMELR/TIMEHR
+// pair is avoided because its latch is shared by both cores.
+static inline uint64_t timebase_now_us(void) {
+    uint32_t hi = timer_hw->timerawh;
+    uint32_t lo;
+    uint32_t prev;
+    do {
+        prev = hi;
+        lo = timer_hw->timerawl;
+        hi = timer_hw->timerawh;
+    } while (hi != prev);
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// Low 32 bits of the timebase (wraps after ~71 minutes; use for short intervals)
+static inline uint32_t timebase_now_us32(void) {
+    return timer_hw->timerawl;
+}
+
+// ─────────────────────────────────────────────────────────────
+// High 64 bits of a 64x64-bit product, built from 32-bit multiplies
+static inline uint64_t timebase_mulhi64(uint64_t a, uint64_t b) {
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+}
+
+// Microseconds to milliseconds: reciprocal multiply, exact for us < 2^63
+static inline uint64_t timebase_us_to_ms(uint64_t us) {
+    return timebase_mulhi64(us, 0x20C49BA5E353F7CFull) >> 7;
+}
+
+// Microseconds to clk_sys cycles (Q16.16 multiply)
+static inline uint64_t timebase_us_to_cycles(uint32_t us) {
+    return ((uint64_t)us * timebase_calib.cycles_per_us_q16) >> 16;
+}
+
+// Nanoseconds to clk_sys cycles (Q0.32 multiply)
+static inline uint32_t timebase_ns_to_cycles(uint32_t ns) {
+    return (uint32_t)(((uint64_t)ns * timebase_calib.cycles_per_ns_q32) >> 32);
+}
+
+// clk_sys cycles to microseconds (Q0.32 multiply)
+static inline uint32_t timebase_cycles_to_us(uint32_t cycles) {
+    return (uint32_t)(((uint64_t)cycles * timebase_calib.us_per_cycle_q32) >> 32);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,766 @@
+#include "flash_kv.h"
+#include "ros_sync.h"
+#include "scheduler.h"
+#include "timebase.h"
+#include <string.h>
+
+#define KV_MAGIC 0x31564B52u        // "RKV1"
+#define KV_NONE  0xFFFFFFFFu        // Erased word
+
+// First 32 bytes of every formatted sector. magic, erase_count and hdr_crc are
+// programmed right after the erase, seq/seq_inv when the sector joins the log.
+typedef struct {
+    uint32_t magic;
+    uint32_t erase_count;
+    uint32_t hdr_crc;               // Over magic and erase_count
+    uint32_t seq;                   // Position in the log
+    uint32_t seq_inv;               // ~seq: a torn seq write never reads as valid
+    uint32_t reserved[3];
+} kv_sector_hdr_t;
+
+// Record header; the key and value follow, padded to 4 bytes
+typedef struct {
+    uint32_t crc;                   // Over the rest of the header, the key and the value
+    uint32_t txn;
+    uint8_t type;
+    uint8_t key_len;
+    uint16_t val_len;
+} kv_rec_t;
+
+enum {
+    REC_PUT = 1,
+    REC_DEL = 2,
+    REC_COMMIT = 3,                 // Makes every PUT/DEL of its txn take effect
+    REC_MOVE = 4,                   // Copy made while reclaiming; takes effect on its own
+};
+
+enum {
+    SEC_ERASED,                     // All 0xFF: no header, erase count unknown
+    SEC_FREE,                       // Header written, ready to join the log
+    SEC_LOG,
+    SEC_DIRTY,                      // Unreadable header or torn seq; erase before use
+};
+
+#define KV_HDR_SIZE sizeof(kv_sector_hdr_t)
+#define KV_ALIGN(n) (((n) + 3u) & ~3u)
+#define KV_REC_SIZE(key_len, val_len) KV_ALIGN(sizeof(kv_rec_t) + (key_len) + (val_len))
+
+/// Bytes of live records the region can hold: one sector is kept for reclaiming, one may be half written
+#define KV_CAPACITY ((FLASH_KV_SECTORS - 2u) * (FLASH_KV_SECTOR_SIZE - KV_HDR_SIZE))
+
+_Static_assert(sizeof(kv_sector_hdr_t) == 32, "sector header layout");
+_Static_assert(sizeof(kv_rec_t) == 12, "record header layout");
+_Static_assert(FLASH_KV_SECTORS >= 3, "FLASH_KV_SECTORS must be at least 3");
+_Static_assert(FLASH_KV_MAX_KEY_LEN <= 255 && FLASH_KV_MAX_VALUE <= 0xFFFF, "key or value too long for the record header");
+_Static_assert(KV_HDR_SIZE + KV_REC_SIZE(FLASH_KV_MAX_KEY_LEN, FLASH_KV_MAX_VALUE) <= FLASH_KV_SECTOR_SIZE,
+               "the largest record must fit in one sector");
+_Static_assert(FLASH_KV_GC_AHEAD >= 1 && FLASH_KV_GC_AHEAD < FLASH_KV_SECTORS, "FLASH_KV_GC_AHEAD out of range");
+
+typedef struct {
+    uint32_t seq;
+    uint32_t erase_count;
+    uint32_t used;                  // Write offset: header plus records
+    uint32_t live;                  // Bytes of records the key table points at
+    uint8_t state;
+} kv_sector_t;
+
+// Key table entry; keys are compared from flash when the hashes match
+typedef struct {
+    uint32_t addr;
+    uint16_t hash;
+    uint16_t size;
+} kv_entry_t;
+
+static kv_sector_t sectors[FLASH_KV_SECTORS];
+static kv_entry_t entries[FLASH_KV_MAX_KEYS];
+static uint32_t n_entries;
+
+static uint32_t staged[FLASH_KV_MAX_STAGED];     // Records of the open transaction, oldest first
+static uint32_t n_staged;
+static uint32_t staged_new_keys;                 // Keys the open transaction adds to the table
+
+static int active = -1;                          // Sector at the head of the log
+static uint32_t next_seq;
+static uint32_t txn;
+static bool mounted;
+
+// Page being filled; programmed whole when the log moves past it or at commit
+static uint8_t page_buf[FLASH_KV_PAGE_SIZE] __attribute__((aligned(4)));
+static uint32_t page_addr = KV_NONE;
+static bool page_dirty;
+
+static flash_kv_stats_t stats;
+static ros_mutex_t kv_mutex;
+
+#define KV_LOCK() ros_mutex_lock(&kv_mutex, ROS_WAIT_FOREVER)
+#define KV_UNLOCK() ros_mutex_unlock(&kv_mutex)
+
+// ─────────────────────────────────────────────────────────────
+// Checksums
+
+// CRC-32 (IEEE), a nibble at a time: a 64-byte table instead of 1 KiB
+static uint32_t kv_crc32(uint32_t crc, const void* data, uint32_t len) {
+    static const uint32_t nibble[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    const uint8_t* p = data;
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ nibble[crc & 15];
+        crc = (crc >> 4) ^ nibble[crc & 15];
+    }
+    return ~crc;
+}
+
+// FNV-1a folded to 16 bits
+static uint16_t kv_hash(const char* key, uint32_t len) {
+    uint32_t h = 2166136261u;
+    while (len--) {
+        h ^= (uint8_t)*key++;
+        h *= 16777619u;
+    }
+    return (uint16_t)(h ^ (h >> 16));
+}
+
+// ─────────────────────────────────────────────────────────────
+// Flash access
+
+static int kv_flush(void) {
+    if (!page_dirty) return FLASH_KV_OK;
+    uint64_t start = timebase_now_us();
+    if (flash_kv_port_program(page_addr, page_buf)) return FLASH_KV_IO;
+    uint32_t took = (uint32_t)(timebase_now_us() - start);
+    if (took > stats.max_program_us) stats.max_program_us = took;
+    stats.page_programs++;
+    stats.flash_bytes += FLASH_KV_PAGE_SIZE;
+    page_dirty = false;
+    return FLASH_KV_OK;
+}
+
+// Reads see bytes still waiting in the page buffer
+static int kv_read(uint32_t addr, void* buf, uint32_t len) {
+    if (flash_kv_port_read(addr, buf, len)) return FLASH_KV_IO;
+    if (page_dirty && addr < page_addr + FLASH_KV_PAGE_SIZE && addr + len > page_addr) {
+        uint32_t from = addr > page_addr ? addr : page_addr;
+        uint32_t to = addr + len < page_addr + FLASH_KV_PAGE_SIZE ? addr + len : page_addr + FLASH_KV_PAGE_SIZE;
+        memcpy((uint8_t*)buf + (from - addr), page_buf + (from - page_addr), to - from);
+    }
+    return FLASH_KV_OK;
+}
+
+// Append into the page buffer; moving to another page programs the current one
+static int kv_write(uint32_t addr, const void* data, uint32_t len) {
+    const uint8_t* p = data;
+    while (len) {
+        uint32_t page = addr & ~(FLASH_KV_PAGE_SIZE - 1);
+        if (page != page_addr) {
+            int r = kv_flush();
+            if (r) return r;
+            // Programming the whole page again is harmless: bits already at 0 stay 0
+            if (flash_kv_port_read(page, page_buf, FLASH_KV_PAGE_SIZE)) return FLASH_KV_IO;
+            page_addr = page;
+        }
+        uint32_t n = page + FLASH_KV_PAGE_SIZE - addr;
+        if (n > len) n = len;
+        memcpy(page_buf + (addr - page), p, n);
+        page_dirty = true;
+        addr += n;
+        p += n;
+        len -= n;
+    }
+    return FLASH_KV_OK;
+}
+
+static bool kv_is_erased(uint32_t addr, uint32_t end) {
+    uint8_t chunk[64];
+    while (addr < end) {
+        uint32_t n = end - addr < sizeof chunk ? end - addr : sizeof chunk;
+        if (kv_read(addr, chunk, n)) return false;
+        for (uint32_t i = 0; i < n; i++) {
+            if (chunk[i] != 0xFF) return false;
+        }
+        addr += n;
+    }
+    return true;
+}
+
+static int kv_write_header(int s, uint32_t erase_count) {
+    kv_sector_hdr_t hdr;
+    memset(&hdr, 0xFF, sizeof hdr);
+    hdr.magic = KV_MAGIC;
+    hdr.erase_count = erase_count;
+    hdr.hdr_crc = kv_crc32(0, &hdr, 8);
+    int r = kv_write((uint32_t)s * FLASH_KV_SECTOR_SIZE, &hdr, sizeof hdr);
+    if (!r) r = kv_flush();
+    if (r) return r;
+    sectors[s] = (kv_sector_t){ .seq = KV_NONE, .erase_count = erase_count, .used = KV_HDR_SIZE, .state = SEC_FREE };
+    return FLASH_KV_OK;
+}
+
+// Erase and write the new count at once, so the count survives a power cut
+static int kv_erase(int s) {
+    uint32_t base = (uint32_t)s * FLASH_KV_SECTOR_SIZE;
+    if (page_addr - base < FLASH_KV_SECTOR_SIZE) {
+        page_addr = KV_NONE;
+        page_dirty = false;
+    }
+    sectors[s].state = SEC_DIRTY;
+
+    uint64_t start = timebase_now_us();
+    if (flash_kv_port_erase(base)) return FLASH_KV_IO;
+    uint32_t took = (uint32_t)(timebase_now_us() - start);
+    if (took > stats.max_erase_us) stats.max_erase_us = took;
+    stats.sector_erases++;
+
+    return kv_write_header(s, sectors[s].erase_count + 1);
+}
+
+// ─────────────────────────────────────────────────────────────
+// Log
+
+static uint32_t kv_free_sectors(void) {
+    uint32_t n = 0;
+    for (int s = 0; s < (int)FLASH_KV_SECTORS; s++) {
+        if (sectors[s].state != SEC_LOG) n++;
+    }
+    return n;
+}
+
+static int kv_oldest(void) {
+    int oldest = -1;
+    for (int s = 0; s < (int)FLASH_KV_SECTORS; s++) {
+        if (sectors[s].state == SEC_LOG && (oldest < 0 || sectors[s].seq < sectors[oldest].seq)) oldest = s;
+    }
+    return oldest;
+}
+
+// Start a new head sector: the least worn one outside the log. Only reclaiming may take the last one.
+static int kv_open_sector(bool reclaiming) {
+    if (kv_free_sectors() <= (reclaiming ? 0u : 1u)) return FLASH_KV_FULL;
+
+    int best = -1;
+    for (int s = 0; s < (int)FLASH_KV_SECTORS; s++) {
+        if (sectors[s].state == SEC_LOG) continue;
+        if (best < 0 || sectors[s].erase_count < sectors[best].erase_count) best = s;
+    }
+
+    int r = FLASH_KV_OK;
+    if (sectors[best].state == SEC_ERASED) r = kv_write_header(best, sectors[best].erase_count);
+    else if (sectors[best].state == SEC_DIRTY) r = kv_erase(best);
+    if (r) return r;
+
+    uint32_t seq[2] = { next_seq, ~next_seq };
+    r = kv_write((uint32_t)best * FLASH_KV_SECTOR_SIZE + offsetof(kv_sector_hdr_t, seq), seq, sizeof seq);
+    if (r) return r;
+    sectors[best].seq = next_seq++;
+    sectors[best].state = SEC_LOG;
+    active = best;
+    return FLASH_KV_OK;
+}
+
+// Find room for `size` bytes at the head of the log
+static int kv_reserve(uint32_t size, bool reclaiming, uint32_t* addr) {
+    if (active < 0 || sectors[active].used + size > FLASH_KV_SECTOR_SIZE) {
+        int r = kv_open_sector(reclaiming);
+        if (r) return r;
+    }
+    *addr = (uint32_t)active * FLASH_KV_SECTOR_SIZE + sectors[active].used;
+    sectors[active].used += size;
+    return FLASH_KV_OK;
+}
+
+static int kv_append(uint8_t type, const char* key, uint32_t key_len, const void* value, uint32_t val_len,
+                     uint32_t* at) {
+    uint32_t addr;
+    int r = kv_reserve(KV_REC_SIZE(key_len, val_len), false, &addr);
+    if (r) return r;
+
+    kv_rec_t rec = { .txn = txn, .type = type, .key_len = (uint8_t)key_len, .val_len = (uint16_t)val_len };
+    rec.crc = kv_crc32(0, &rec.txn, sizeof rec - sizeof rec.crc);
+    rec.crc = kv_crc32(rec.crc, key, key_len);
+    rec.crc = kv_crc32(rec.crc, value, val_len);
+
+    r = kv_write(addr, &rec, sizeof rec);
+    if (!r) r = kv_write(addr + sizeof rec, key, key_len);
+    if (!r) r = kv_write(addr + sizeof rec + key_len, value, val_len);
+    if (r) return r;
+    if (at) *at = addr;
+    return FLASH_KV_OK;
+}
+
+/**
+ * Read and check the record at `addr`.
+ * @return 1 for a valid record, 0 for the erased end of the log, -1 for a torn or foreign one.
+ */
+static int kv_read_rec(uint32_t addr, uint32_t end, kv_rec_t* rec) {
+    if (addr + sizeof *rec > end) return 0;
+    if (kv_read(addr, rec, sizeof *rec)) return -1;
+    if (rec->crc == KV_NONE && rec->txn == KV_NONE && rec->type == 0xFF) return 0;
+
+    bool keyed = rec->type == REC_PUT || rec->type == REC_DEL || rec->type == REC_MOVE;
+    if (rec->type < REC_PUT || rec->type > REC_MOVE) return -1;
+    if (keyed ? rec->key_len == 0 || rec->key_len > FLASH_KV_MAX_KEY_LEN : rec->key_len != 0) return -1;
+    if (rec->val_len > FLASH_KV_MAX_VALUE) return -1;
+    if (addr + KV_REC_SIZE(rec->key_len, rec->val_len) > end) return -1;
+
+    uint32_t crc = kv_crc32(0, &rec->txn, sizeof *rec - sizeof rec->crc);
+    uint8_t chunk[64];
+    uint32_t off = addr + sizeof *rec;
+    uint32_t left = rec->key_len + rec->val_len;
+    while (left) {
+        uint32_t n = left < sizeof chunk ? left : sizeof chunk;
+        if (kv_read(off, chunk, n)) return -1;
+        crc = kv_crc32(crc, chunk, n);
+        off += n;
+        left -= n;
+    }
+    return crc == rec->crc ? 1 : -1;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Key table
+
+static bool kv_key_is(uint32_t addr, const kv_rec_t* rec, const char* key, uint32_t key_len) {
+    char stored[FLASH_KV_MAX_KEY_LEN];
+    if (rec->key_len != key_len) return false;
+    if (kv_read(addr + sizeof *rec, stored, key_len)) return false;
+    return memcmp(stored, key, key_len) == 0;
+}
+
+static int kv_find(const char* key, uint32_t key_len, uint16_t hash) {
+    for (uint32_t i = 0; i < n_entries; i++) {
+        if (entries[i].hash != hash) continue;
+        kv_rec_t rec;
+        if (kv_read(entries[i].addr, &rec, sizeof rec)) continue;
+        if (kv_key_is(entries[i].addr, &rec, key, key_len)) return (int)i;
+    }
+    return -1;
+}
+
+static bool kv_is_staged(const char* key, uint32_t key_len) {
+    for (uint32_t i = 0; i < n_staged; i++) {
+        kv_rec_t rec;
+        if (kv_read(staged[i], &rec, sizeof rec)) continue;
+        if (kv_key_is(staged[i], &rec, key, key_len)) return true;
+    }
+    return false;
+}
+
+// Let a PUT, DEL or MOVE record take effect
+static void kv_apply(uint32_t addr, const kv_rec_t* rec) {
+    char key[FLASH_KV_MAX_KEY_LEN];
+    if (kv_read(addr + sizeof *rec, key, rec->key_len)) return;
+    uint16_t hash = kv_hash(key, rec->key_len);
+
+    int i = kv_find(key, rec->key_len, hash);
+    if (i >= 0) {
+        sectors[entries[i].addr / FLASH_KV_SECTOR_SIZE].live -= entries[i].size;
+        if (rec->type == REC_DEL) {
+            entries[i] = entries[--n_entries];
+            return;
+        }
+    } else {
+        if (rec->type == REC_DEL || n_entries == FLASH_KV_MAX_KEYS) return;
+        i = (int)n_entries++;
+    }
+
+    uint16_t size = (uint16_t)KV_REC_SIZE(rec->key_len, rec->val_len);
+    entries[i] = (kv_entry_t){ .addr = addr, .hash = hash, .size = size };
+    sectors[addr / FLASH_KV_SECTOR_SIZE].live += size;
+}
+
+// Newest staged record for the key, else the committed one
+static int kv_lookup(const char* key, uint32_t key_len, uint32_t* addr, kv_rec_t* rec) {
+    for (int i = (int)n_staged - 1; i >= 0; i--) {
+        if (kv_read(staged[i], rec, sizeof *rec)) return FLASH_KV_IO;
+        if (!kv_key_is(staged[i], rec, key, key_len)) continue;
+        if (rec->type == REC_DEL) return FLASH_KV_NOT_FOUND;
+        *addr = staged[i];
+        return FLASH_KV_OK;
+    }
+
+    int i = kv_find(key, key_len, kv_hash(key, key_len));
+    if (i < 0) return FLASH_KV_NOT_FOUND;
+    *addr = entries[i].addr;
+    return kv_read(*addr, rec, sizeof *rec) ? FLASH_KV_IO : FLASH_KV_OK;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Reclaiming
+
+// Copy a live record to the head of the log as a MOVE
+static int kv_move(uint32_t from, uint32_t* to) {
+    kv_rec_t rec;
+    if (kv_read(from, &rec, sizeof rec)) return FLASH_KV_IO;
+    uint32_t payload = rec.key_len + rec.val_len;
+
+    uint32_t addr;
+    int r = kv_reserve(KV_REC_SIZE(rec.key_len, rec.val_len), true, &addr);
+    if (r) return r;
+
+    // The type changes, so the CRC is taken again before the header goes out
+    rec.type = REC_MOVE;
+    rec.crc = kv_crc32(0, &rec.txn, sizeof rec - sizeof rec.crc);
+    uint8_t chunk[64];
+    for (uint32_t off = 0; off < payload; off += sizeof chunk) {
+        uint32_t n = payload - off < sizeof chunk ? payload - off : sizeof chunk;
+        if (kv_read(from + sizeof rec + off, chunk, n)) return FLASH_KV_IO;
+        rec.crc = kv_crc32(rec.crc, chunk, n);
+    }
+
+    r = kv_write(addr, &rec, sizeof rec);
+    for (uint32_t off = 0; !r && off < payload; off += sizeof chunk) {
+        uint32_t n = payload - off < sizeof chunk ? payload - off : sizeof chunk;
+        r = kv_read(from + sizeof rec + off, chunk, n);
+        if (!r) r = kv_write(addr + sizeof rec + off, chunk, n);
+    }
+    if (r) return r;
+    *to = addr;
+    return FLASH_KV_OK;
+}
+
+// Move the oldest sector's live records to the head, then erase it
+static int kv_collect(void) {
+    int victim = kv_oldest();
+    if (victim < 0 || victim == active) return FLASH_KV_FULL;
+    // The open transaction's records must stay until its commit is written
+    if (n_staged && staged[0] / FLASH_KV_SECTOR_SIZE == (uint32_t)victim) return FLASH_KV_FULL;
+
+    // Copies that do not fit the head all go to a fresh sector, which then holds nothing
+    // else until the victim is erased; mount drops such a sector if power fails in between
+    if (sectors[active].used + sectors[victim].live > FLASH_KV_SECTOR_SIZE) {
+        int r = kv_open_sector(true);
+        if (r) return r;
+    }
+
+    for (uint32_t i = 0; i < n_entries; i++) {
+        if (entries[i].addr / FLASH_KV_SECTOR_SIZE != (uint32_t)victim) continue;
+        uint32_t to;
+        int r = kv_move(entries[i].addr, &to);
+        if (r) return r;
+        sectors[victim].live -= entries[i].size;
+        sectors[to / FLASH_KV_SECTOR_SIZE].live += entries[i].size;
+        entries[i].addr = to;
+        stats.gc_bytes += entries[i].size;
+    }
+
+    // The copies must be on flash before the originals go
+    int r = kv_flush();
+    if (r) return r;
+    stats.gc_runs++;
+    return kv_erase(victim);
+}
+
+static uint32_t kv_live_bytes(void) {
+    uint32_t live = 0;
+    for (int s = 0; s < (int)FLASH_KV_SECTORS; s++) live += sectors[s].live;
+    return live;
+}
+
+// Reclaim until a normal append may open a sector again
+static int kv_make_room(uint32_t size) {
+    if (kv_live_bytes() + size > KV_CAPACITY) return FLASH_KV_FULL;
+    for (uint32_t i = 0; i < FLASH_KV_SECTORS && kv_free_sectors() <= 1; i++) {
+        int r = kv_collect();
+        if (r) return r;
+    }
+    return kv_free_sectors() > 1 ? FLASH_KV_OK : FLASH_KV_FULL;
+}
+
+static int kv_append_or_collect(uint8_t type, const char* key, uint32_t key_len, const void* value,
+                                uint32_t val_len, uint32_t* at) {
+    int r = kv_append(type, key, key_len, value, val_len, at);
+    if (r == FLASH_KV_FULL) {
+        r = kv_make_room(KV_REC_SIZE(key_len, val_len));
+        if (!r) r = kv_append(type, key, key_len, value, val_len, at);
+    }
+    return r;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Mount
+
+// Apply the PUT/DEL records of a committed txn, from its first record up to its COMMIT
+static void kv_replay_txn(const int* order, uint32_t i, uint32_t off, uint32_t end_i, uint32_t end_off, uint32_t t) {
+    while (i < end_i || (i == end_i && off < end_off)) {
+        uint32_t base = (uint32_t)order[i] * FLASH_KV_SECTOR_SIZE;
+        kv_rec_t rec;
+        if (kv_read_rec(base + off, base + FLASH_KV_SECTOR_SIZE, &rec) <= 0) {
+            i++;
+            off = KV_HDR_SIZE;
+            continue;
+        }
+        if (rec.txn == t && (rec.type == REC_PUT || rec.type == REC_DEL)) kv_apply(base + off, &rec);
+        off += KV_REC_SIZE(rec.key_len, rec.val_len);
+    }
+}
+
+static void kv_replay(void) {
+    // Log sectors, oldest first
+    int order[FLASH_KV_SECTORS];
+    uint32_t n = 0;
+    for (int s = 0; s < (int)FLASH_KV_SECTORS; s++) {
+        if (sectors[s].state != SEC_LOG) continue;
+        uint32_t j = n++;
+        while (j > 0 && sectors[order[j - 1]].seq > sectors[s].seq) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = s;
+    }
+
+    uint32_t pending = KV_NONE;         // txn whose records have been seen but not its COMMIT
+    uint32_t pending_i = 0;
+    uint32_t pending_off = 0;
+    uint32_t last_txn = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        int s = order[i];
+        uint32_t base = (uint32_t)s * FLASH_KV_SECTOR_SIZE;
+        uint32_t off = KV_HDR_SIZE;
+        for (;;) {
+            kv_rec_t rec;
+            int v = kv_read_rec(base + off, base + FLASH_KV_SECTOR_SIZE, &rec);
+            if (v <= 0) {
+                // Anything but clean 0xFF after the last record is a torn write: close the sector
+                bool clean = v == 0 && kv_is_erased(base + off, base + FLASH_KV_SECTOR_SIZE);
+                sectors[s].used = clean ? off : FLASH_KV_SECTOR_SIZE;
+                break;
+            }
+            if (rec.txn > last_txn) last_txn = rec.txn;
+
+            if (rec.type == REC_MOVE) {
+                kv_apply(base + off, &rec);
+            } else if (rec.type == REC_COMMIT) {
+                if (rec.txn == pending) kv_replay_txn(order, pending_i, pending_off, i, off, pending);
+                pending = KV_NONE;
+            } else if (rec.txn != pending) {
+                // A new txn; one still pending lost power before its commit
+                pending = rec.txn;
+                pending_i = i;
+                pending_off = off;
+            }
+            off += KV_REC_SIZE(rec.key_len, rec.val_len);
+        }
+    }
+
+    txn = last_txn + 1;
+    active = n ? order[n - 1] : -1;
+    next_seq = n ? sectors[order[n - 1]].seq + 1 : 0;
+}
+
+int flash_kv_mount(void) {
+    ros_mutex_init(&kv_mutex, false);
+    mounted = false;
+    memset(sectors, 0, sizeof sectors);
+    memset(&stats, 0, sizeof stats);
+    n_entries = 0;
+    n_staged = 0;
+    staged_new_keys = 0;
+    page_addr = KV_NONE;
+    page_dirty = false;
+
+    if (flash_kv_port_init()) return FLASH_KV_IO;
+
+    uint32_t max_count = 0;
+    for (int s = 0; s < (int)FLASH_KV_SECTORS; s++) {
+        kv_sector_hdr_t hdr;
+        kv_sector_t* sec = &sectors[s];
+        sec->seq = KV_NONE;
+        sec->used = FLASH_KV_SECTOR_SIZE;
+        if (flash_kv_port_read((uint32_t)s * FLASH_KV_SECTOR_SIZE, &hdr, sizeof hdr)) return FLASH_KV_IO;
+
+        if (hdr.magic == KV_MAGIC && hdr.hdr_crc == kv_crc32(0, &hdr, 8)) {
+            sec->erase_count = hdr.erase_count;
+            if (hdr.erase_count > max_count) max_count = hdr.erase_count;
+            if (hdr.seq == KV_NONE && hdr.seq_inv == KV_NONE) {
+                sec->state = SEC_FREE;
+                sec->used = KV_HDR_SIZE;
+            } else if (hdr.seq_inv == ~hdr.seq) {
+                sec->state = SEC_LOG;
+                sec->seq = hdr.seq;
+            } else {
+                sec->state = SEC_DIRTY;
+            }
+        } else {
+            // The whole sector is checked: a torn erase can leave the first bytes clean
+            uint32_t base = (uint32_t)s * FLASH_KV_SECTOR_SIZE;
+            sec->state = kv_is_erased(base, base + FLASH_KV_SECTOR_SIZE) ? SEC_ERASED : SEC_DIRTY;
+        }
+    }
+
+    // A sector whose count was lost is taken to be as worn as the worst one
+    for (int s = 0; s < (int)FLASH_KV_SECTORS; s++) {
+        if (sectors[s].state == SEC_ERASED || sectors[s].state == SEC_DIRTY) sectors[s].erase_count = max_count;
+    }
+
+    // No free sector means power failed while reclaiming into the last one. Its
+    // copies are all still in the victim, so it is dropped and the reclaim redone.
+    if (kv_free_sectors() == 0) {
+        int newest = 0;
+        for (int s = 1; s < (int)FLASH_KV_SECTORS; s++) {
+            if (sectors[s].seq > sectors[newest].seq) newest = s;
+        }
+        sectors[newest].state = SEC_DIRTY;
+    }
+
+    kv_replay();
+    mounted = true;
+    return FLASH_KV_OK;
+}
+
+int flash_kv_format(void) {
+    // Mount first so the erase counts carry over
+    int r = flash_kv_mount();
+    if (r) return r;
+    KV_LOCK();
+    for (int s = 0; s < (int)FLASH_KV_SECTORS && !r; s++) r = kv_erase(s);
+    KV_UNLOCK();
+    return r ? r : flash_kv_mount();
+}
+
+// ─────────────────────────────────────────────────────────────
+// API
+
+static int kv_key_len(const char* key) {
+    if (!mounted || !key) return FLASH_KV_INVALID;
+    size_t len = strnlen(key, FLASH_KV_MAX_KEY_LEN + 1);
+    return len == 0 || len > FLASH_KV_MAX_KEY_LEN ? FLASH_KV_INVALID : (int)len;
+}
+
+static int kv_stage(uint8_t type, const char* key, uint32_t key_len, const void* value, uint32_t val_len) {
+    if (n_staged == FLASH_KV_MAX_STAGED) return FLASH_KV_FULL;
+
+    // A key new to the table needs a slot when the commit applies it
+    bool is_new = type == REC_PUT && kv_find(key, key_len, kv_hash(key, key_len)) < 0 && !kv_is_staged(key, key_len);
+    if (is_new && n_entries + staged_new_keys >= FLASH_KV_MAX_KEYS) return FLASH_KV_FULL;
+
+    uint32_t addr;
+    int r = kv_append_or_collect(type, key, key_len, value, val_len, &addr);
+    if (r) return r;
+    staged[n_staged++] = addr;
+    if (is_new) staged_new_keys++;
+    return FLASH_KV_OK;
+}
+
+int flash_kv_put(const char* key, const void* value, size_t len) {
+    int key_len = kv_key_len(key);
+    if (key_len < 0) return key_len;
+    if (len > FLASH_KV_MAX_VALUE || (len && !value)) return FLASH_KV_INVALID;
+
+    KV_LOCK();
+    int r = kv_stage(REC_PUT, key, (uint32_t)key_len, value, (uint32_t)len);
+    if (!r) stats.user_bytes += (uint32_t)key_len + len;
+    KV_UNLOCK();
+    return r;
+}
+
+int flash_kv_del(const char* key) {
+    int key_len = kv_key_len(key);
+    if (key_len < 0) return key_len;
+
+    KV_LOCK();
+    uint32_t addr;
+    kv_rec_t rec;
+    int r = kv_lookup(key, (uint32_t)key_len, &addr, &rec);
+    if (!r) r = kv_stage(REC_DEL, key, (uint32_t)key_len, NULL, 0);
+    KV_UNLOCK();
+    return r;
+}
+
+int flash_kv_get(const char* key, void* buf, size_t cap) {
+    int key_len = kv_key_len(key);
+    if (key_len < 0) return key_len;
+
+    KV_LOCK();
+    uint32_t addr;
+    kv_rec_t rec;
+    int r = kv_lookup(key, (uint32_t)key_len, &addr, &rec);
+    if (!r) {
+        uint32_t n = rec.val_len < cap ? rec.val_len : (uint32_t)cap;
+        if (buf && n && kv_read(addr + sizeof rec + rec.key_len, buf, n)) r = FLASH_KV_IO;
+        else r = rec.val_len;
+    }
+    KV_UNLOCK();
+    return r;
+}
+
+int flash_kv_commit(void) {
+    if (!mounted) return FLASH_KV_INVALID;
+
+    KV_LOCK();
+    int r = FLASH_KV_OK;
+    if (n_staged) {
+        r = kv_append_or_collect(REC_COMMIT, NULL, 0, NULL, 0, NULL);
+        if (!r) r = kv_flush();
+    }
+    // On failure the changes stay staged; committing again writes another COMMIT for the same txn
+    if (!r && n_staged) {
+        for (uint32_t i = 0; i < n_staged; i++) {
+            kv_rec_t rec;
+            if (!kv_read(staged[i], &rec, sizeof rec)) kv_apply(staged[i], &rec);
+        }
+        n_staged = 0;
+        staged_new_keys = 0;
+        txn++;
+        stats.commits++;
+    }
+    KV_UNLOCK();
+    return r;
+}
+
+int flash_kv_maintain(void) {
+    if (!mounted) return FLASH_KV_INVALID;
+
+    KV_LOCK();
+    int r = 0;
+    if (kv_free_sectors() <= FLASH_KV_GC_AHEAD) {
+        // Worth a pass only once a sector's worth of space can come back
+        uint32_t garbage = 0;
+        for (int s = 0; s < (int)FLASH_KV_SECTORS; s++) {
+            if (sectors[s].state == SEC_LOG && s != active) garbage += sectors[s].used - KV_HDR_SIZE - sectors[s].live;
+        }
+        if (garbage >= FLASH_KV_SECTOR_SIZE - KV_HDR_SIZE) {
+            r = kv_collect();
+            r = r == FLASH_KV_FULL ? 0 : r ? r : 1;
+        }
+    }
+    if (r == 0) {
+        for (int s = 0; s < (int)FLASH_KV_SECTORS; s++) {
+            if (sectors[s].state == SEC_DIRTY || sectors[s].state == SEC_ERASED) {
+                r = sectors[s].state == SEC_DIRTY ? kv_erase(s) : kv_write_header(s, sectors[s].erase_count);
+                if (!r) r = 1;
+                break;
+            }
+        }
+    }
+    KV_UNLOCK();
+    return r;
+}
+
+void flash_kv_task(void) {
+    // One step per dispatch: after work, come back at the next schedule(); when idle, after a period
+    uint64_t delay_us = flash_kv_maintain() > 0 ? 0 : FLASH_KV_MAINTAIN_PERIOD_US;
+    process_sleep_until(timebase_now_us() + delay_us);
+}
+
+void flash_kv_get_stats(flash_kv_stats_t* out) {
+    if (!mounted) {
+        memset(out, 0, sizeof *out);
+        return;
+    }
+    KV_LOCK();
+    *out = stats;
+    out->keys = n_entries;
+    out->live_bytes = kv_live_bytes();
+    out->free_sectors = kv_free_sectors();
+    out->erase_min = UINT32_MAX;
+    out->erase_max = 0;
+    for (int s = 0; s < (int)FLASH_KV_SECTORS; s++) {
+        if (sectors[s].erase_count < out->erase_min) out->erase_min = sectors[s].erase_count;
+        if (sectors[s].erase_count > out->erase_max) out->erase_max = sectors[s].erase_count;
+    }
+    KV_UNLOCK();
+}
@@ -0,0 +1,196 @@
+#pragma once
+/**
+ * @file flash_kv.h
+ * @brief Log-structured key-value store in a reserved flash region.
+ *
+ * Records are appended to a log that runs through the region's sectors in
+ * turn; nothing is rewritten in place. Puts and deletes are staged, and
+ * flash_kv_commit() makes all staged changes durable at once: a power cut
+ * before the commit record reaches flash leaves the previous state, after
+ * it the new one. Every record carries a CRC-32, so a torn write is found
+ * and ignored at the next mount.
+ *
+ * When free sectors run low, the oldest sector's live records are copied to
+ * the head of the log and the sector is erased. Since the oldest sector is
+ * always the one reclaimed, the log rotates through the whole region and
+ * rarely changed data (calibration) moves with it: every sector sees about
+ * the same number of erases. Erase counts are kept in each sector header.
+ *
+ * Flash access goes through a small port (flash_kv_rp2040.c on target,
+ * host/flash_kv_sim.c for the file-backed simulator). Writes are gathered
+ * into 256-byte pages and programmed one page per flash operation, so the
+ * other core is parked only for a page program or a sector erase at a time.
+ * Reclaiming and erasing ahead of demand is left to flash_kv_maintain(),
+ * normally run by flash_kv_task() at low priority.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Erase unit of the flash
+#define FLASH_KV_SECTOR_SIZE 4096u
+
+/// Program unit of the flash
+#define FLASH_KV_PAGE_SIZE 256u
+
+/// Sectors in the region (at least 3: the log, one to write into, one reserved for reclaiming)
+#ifndef FLASH_KV_SECTORS
+#define FLASH_KV_SECTORS 16u
+#endif
+
+/// Bytes of flash the store occupies
+#define FLASH_KV_SIZE (FLASH_KV_SECTORS * FLASH_KV_SECTOR_SIZE)
+
+/// Most keys stored at once (each costs 8 bytes of RAM)
+#ifndef FLASH_KV_MAX_KEYS
+#define FLASH_KV_MAX_KEYS 128u
+#endif
+
+/// Longest key, in bytes without the terminator
+#ifndef FLASH_KV_MAX_KEY_LEN
+#define FLASH_KV_MAX_KEY_LEN 32u
+#endif
+
+/// Largest value
+#ifndef FLASH_KV_MAX_VALUE
+#define FLASH_KV_MAX_VALUE 1024u
+#endif
+
+/// Puts and deletes one commit can hold
+#ifndef FLASH_KV_MAX_STAGED
+#define FLASH_KV_MAX_STAGED 16u
+#endif
+
+/// flash_kv_maintain() reclaims a sector once this few sectors are free
+#ifndef FLASH_KV_GC_AHEAD
+#define FLASH_KV_GC_AHEAD 3u
+#endif
+
+/// Period of flash_kv_task() while there is nothing to reclaim or erase
+#ifndef FLASH_KV_MAINTAIN_PERIOD_US
+#define FLASH_KV_MAINTAIN_PERIOD_US 100000u
+#endif
+
+/// @brief Result codes; lengths and counts are returned as non-negative values.
+typedef enum {
+    FLASH_KV_OK = 0,
+    FLASH_KV_NOT_FOUND = -1,    ///< No such key
+    FLASH_KV_FULL = -2,         ///< No room: region, key table or staged list
+    FLASH_KV_INVALID = -3,      ///< Key or value size out of range, or not mounted
+    FLASH_KV_IO = -4,           ///< The port failed a read, program or erase
+} flash_kv_status_t;
+
+/**
+ * @struct flash_kv_stats_t
+ * @brief Store statistics since mount.
+ *
+ * keys, live_bytes    – current keys and the flash their records occupy
+ * free_sectors        – sectors not holding log data
+ * commits             – flash_kv_commit() calls that wrote a commit record
+ * page_programs       – page program operations
+ * sector_erases       – sector erase operations
+ * gc_runs, gc_bytes   – sectors reclaimed and record bytes copied to do it
+ * user_bytes          – key and value bytes passed to flash_kv_put()
+ * flash_bytes         – bytes programmed (page_programs × page size)
+ * erase_min/max       – lowest and highest sector erase count (wear spread)
+ * max_program_us      – longest page program, i.e. the longest the other core was parked for one
+ * max_erase_us        – longest sector erase
+ */
+typedef struct {
+    uint32_t keys;
+    uint32_t live_bytes;
+    uint32_t free_sectors;
+    uint32_t commits;
+    uint32_t page_programs;
+    uint32_t sector_erases;
+    uint32_t gc_runs;
+    uint32_t gc_bytes;
+    uint64_t user_bytes;
+    uint64_t flash_bytes;
+    uint32_t erase_min;
+    uint32_t erase_max;
+    uint32_t max_program_us;
+    uint32_t max_erase_us;
+} flash_kv_stats_t;
+
+/**
+ * @brief Scan the region and rebuild the key table.
+ *
+ * An erased or foreign region mounts as an empty store; sectors with
+ * unreadable headers are erased when they are next needed.
+ * @return FLASH_KV_OK, or FLASH_KV_IO if the port could not be initialized.
+ */
+int flash_kv_mount(void);
+
+/// @brief Erase the whole region and mount it empty.
+int flash_kv_format(void);
+
+/**
+ * @brief Stage a value for `key` (visible to flash_kv_get() at once, durable after commit).
+ * @return FLASH_KV_OK, FLASH_KV_FULL or FLASH_KV_INVALID.
+ */
+int flash_kv_put(const char* key, const void* value, size_t len);
+
+/**
+ * @brief Stage the removal of `key`.
+ * @return FLASH_KV_OK, FLASH_KV_NOT_FOUND or FLASH_KV_FULL.
+ */
+int flash_kv_del(const char* key);
+
+/**
+ * @brief Copy out the value of `key`, staged changes included.
+ * @param buf Destination, or NULL to query the length.
+ * @param cap Size of `buf`; a longer value is truncated.
+ * @return Length of the value (which may exceed `cap`), or FLASH_KV_NOT_FOUND.
+ */
+int flash_kv_get(const char* key, void* buf, size_t cap);
+
+/**
+ * @brief Make every staged change durable as one atomic step.
+ * @return FLASH_KV_OK once the commit record is programmed, or FLASH_KV_FULL / FLASH_KV_IO.
+ */
+int flash_kv_commit(void);
+
+/**
+ * @brief Do one unit of background work: reclaim a sector or erase a dirty one.
+ * @return 1 if work was done, 0 if there was nothing to do, or a negative status.
+ */
+int flash_kv_maintain(void);
+
+/**
+ * @brief Maintenance process body: one flash_kv_maintain() step per dispatch.
+ *
+ * After a step that did work it is READY again at the next schedule(), so
+ * other processes run between sector erases; when idle it sleeps for
+ * FLASH_KV_MAINTAIN_PERIOD_US. Each step ends in process_sleep_until(), which
+ * switches to whatever else is ready.
+ * Register as a low-priority process, e.g. create_process(flash_kv_task, 0).
+ */
+void flash_kv_task(void);
+
+/// @brief Copy out the statistics.
+void flash_kv_get_stats(flash_kv_stats_t* out);
+
+// ─────────────────────────────────────────────────────────────
+// Port interface (offsets are relative to the start of the region)
+
+/// @brief Prepare the flash; non-zero if the region cannot be used.
+int flash_kv_port_init(void);
+
+/// @brief Read `len` bytes at `offset`.
+int flash_kv_port_read(uint32_t offset, void* buf, uint32_t len);
+
+/// @brief Program one page at the page-aligned `offset` (bits only go from 1 to 0).
+int flash_kv_port_program(uint32_t offset, const void* page);
+
+/// @brief Erase the sector at the sector-aligned `offset` to 0xFF.
+int flash_kv_port_erase(uint32_t offset);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,63 @@
+#include "flash_kv.h"
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include <string.h>
+
+// RP2040 port: the region sits at the top of the on-board flash by default.
+// Programs and erases go through flash_safe_execute(), which parks the other
+// core in RAM (see Kernel::init() and Kernel::launch_core1()) and disables
+// interrupts on this one for the length of a single page or sector operation.
+
+/// Offset of the region from the start of flash
+#ifndef FLASH_KV_OFFSET
+#define FLASH_KV_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_KV_SIZE)
+#endif
+
+/// Longest wait for the other core to park before an operation gives up
+#ifndef FLASH_KV_SAFE_TIMEOUT_MS
+#define FLASH_KV_SAFE_TIMEOUT_MS 100
+#endif
+
+_Static_assert(FLASH_KV_SECTOR_SIZE == FLASH_SECTOR_SIZE, "flash_kv sector size must match the flash");
+_Static_assert(FLASH_KV_PAGE_SIZE == FLASH_PAGE_SIZE, "flash_kv page size must match the flash");
+_Static_assert(FLASH_KV_OFFSET % FLASH_SECTOR_SIZE == 0, "FLASH_KV_OFFSET must be sector aligned");
+
+extern char __flash_binary_end;
+
+typedef struct {
+    uint32_t offset;
+    const void* data;
+} kv_flash_op_t;
+
+static void kv_flash_program(void* param) {
+    const kv_flash_op_t* op = param;
+    flash_range_program(FLASH_KV_OFFSET + op->offset, op->data, FLASH_PAGE_SIZE);
+}
+
+static void kv_flash_erase(void* param) {
+    const kv_flash_op_t* op = param;
+    flash_range_erase(FLASH_KV_OFFSET + op->offset, FLASH_SECTOR_SIZE);
+}
+
+int flash_kv_port_init(void) {
+    // An erase below the end of the image would take program code with it
+    uint32_t image_end = (uint32_t)&__flash_binary_end - XIP_BASE;
+    return image_end <= FLASH_KV_OFFSET ? 0 : -1;
+}
+
+int flash_kv_port_read(uint32_t offset, void* buf, uint32_t len) {
+    // Uncached alias: a mount scan or a large get does not evict kernel code from the XIP cache
+    memcpy(buf, (const void*)(XIP_NOCACHE_NOALLOC_BASE + FLASH_KV_OFFSET + offset), len);
+    return 0;
+}
+
+int flash_kv_port_program(uint32_t offset, const void* page) {
+    kv_flash_op_t op = { offset, page };
+    return flash_safe_execute(kv_flash_program, &op, FLASH_KV_SAFE_TIMEOUT_MS) == PICO_OK ? 0 : -1;
+}
+
+int flash_kv_port_erase(uint32_t offset) {
+    kv_flash_op_t op = { offset, NULL };
+    return flash_safe_execute(kv_flash_erase, &op, FLASH_KV_SAFE_TIMEOUT_MS) == PICO_OK ? 0 : -1;
+}
@@ -0,0 +1,228 @@
+#include "flash_kv.h"
+#include "flash_kv_sim.h"
+#include "pico/stdlib.h"
+#include "timebase.h"
+#include <stdlib.h>
+
+// Host driver for flash_kv on the simulated flash:
+//   flash_kv_sim bench <image> [ops]        wear and write amplification under a calibration + log workload
+//   flash_kv_sim powerfail <image> [cycles] cut power at random points and check every remount
+// Results are JSON lines, like ros_bench.
+
+static uint32_t rng = 12345;
+
+static uint32_t host_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static void fill(uint8_t* buf, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) buf[i] = (uint8_t)host_rand();
+}
+
+static uint64_t sim_busy_us(void) {
+    flash_kv_sim_stats_t s;
+    flash_kv_sim_get_stats(&s);
+    return s.busy_us;
+}
+
+// ─────────────────────────────────────────────────────────────
+// bench
+
+#define BENCH_CAL_KEYS 8            // Written once, like calibration data
+#define BENCH_LOG_KEYS 24           // Rewritten all the time, like crash and event logs
+#define BENCH_BATCH    4            // Puts per commit
+#define BENCH_MAINTAIN 64           // Ops between maintenance passes
+
+static int run_bench(const char* path, uint32_t ops) {
+    if (flash_kv_sim_open(path) || flash_kv_format()) {
+        fprintf(stderr, "flash_kv_sim: cannot format %s\n", path);
+        return 1;
+    }
+
+    char key[16];
+    uint8_t value[128];
+    for (uint32_t i = 0; i < BENCH_CAL_KEYS; i++) {
+        snprintf(key, sizeof key, "cal/%02lu", (unsigned long)i);
+        fill(value, 64);
+        flash_kv_put(key, value, 64);
+    }
+    flash_kv_commit();
+
+    // Foreground stall: flash busy time inside one put or commit, reclaiming included
+    uint64_t stall_max = 0;
+    uint32_t failed = 0;
+    for (uint32_t op = 0; op < ops; op++) {
+        snprintf(key, sizeof key, "log/%02lu", (unsigned long)(host_rand() % BENCH_LOG_KEYS));
+        uint32_t len = 24 + host_rand() % 73;
+        fill(value, len);
+
+        uint64_t busy = sim_busy_us();
+        if (flash_kv_put(key, value, len)) failed++;
+        if (op % BENCH_BATCH == BENCH_BATCH - 1 && flash_kv_commit()) failed++;
+        if (sim_busy_us() - busy > stall_max) stall_max = sim_busy_us() - busy;
+
+        // What flash_kv_task() does over back-to-back dispatches, every FLASH_KV_MAINTAIN_PERIOD_US
+        if (op % BENCH_MAINTAIN == BENCH_MAINTAIN - 1) {
+            while (flash_kv_maintain() > 0) {
+            }
+        }
+    }
+    flash_kv_commit();
+
+    flash_kv_stats_t s;
+    flash_kv_get_stats(&s);
+    flash_kv_sim_stats_t sim;
+    flash_kv_sim_get_stats(&sim);
+
+    printf("{\"bench\":\"flash_kv\",\"platform\":\"host-sim\",\"ops\":%lu,\"failed\":%lu,\"commits\":%lu,"
+           "\"keys\":%lu,\"live_bytes\":%lu,\"user_bytes\":%llu,\"flash_bytes\":%llu,\"write_amp\":%.2f}\n",
+           (unsigned long)ops, (unsigned long)failed, (unsigned long)s.commits, (unsigned long)s.keys,
+           (unsigned long)s.live_bytes, (unsigned long long)s.user_bytes, (unsigned long long)s.flash_bytes,
+           s.user_bytes ? (double)s.flash_bytes / (double)s.user_bytes : 0.0);
+    printf("{\"bench\":\"flash_kv_wear\",\"platform\":\"host-sim\",\"sector_erases\":%lu,\"erase_min\":%lu,"
+           "\"erase_max\":%lu,\"gc_runs\":%lu,\"gc_bytes\":%lu,\"page_programs\":%lu}\n",
+           (unsigned long)s.sector_erases, (unsigned long)s.erase_min, (unsigned long)s.erase_max,
+           (unsigned long)s.gc_runs, (unsigned long)s.gc_bytes, (unsigned long)s.page_programs);
+    printf("{\"bench\":\"flash_kv_stall\",\"platform\":\"host-sim\",\"unit\":\"us\",\"program\":%u,\"erase\":%u,"
+           "\"foreground_max\":%llu,\"busy_total\":%llu}\n",
+           FLASH_KV_SIM_PROGRAM_US, FLASH_KV_SIM_ERASE_US, (unsigned long long)stall_max,
+           (unsigned long long)sim.busy_us);
+
+    // Remount and time the scan
+    uint64_t start = timebase_now_us();
+    int r = flash_kv_mount();
+    uint64_t mount_us = timebase_now_us() - start;
+    flash_kv_get_stats(&s);
+    printf("{\"bench\":\"flash_kv_mount\",\"platform\":\"host-sim\",\"unit\":\"us\",\"status\":%d,\"keys\":%lu,"
+           "\"time\":%llu}\n",
+           r, (unsigned long)s.keys, (unsigned long long)mount_us);
+
+    flash_kv_sim_close();
+    return failed || r ? 1 : 0;
+}
+
+// ─────────────────────────────────────────────────────────────
+// powerfail
+
+#define PF_KEYS      24
+#define PF_VALUE_MAX 200
+
+typedef struct {
+    bool present;
+    uint16_t len;
+    uint8_t data[PF_VALUE_MAX];
+} pf_value_t;
+
+static pf_value_t committed[PF_KEYS];
+static pf_value_t inflight[PF_KEYS];
+
+static void pf_key(char* key, uint32_t i) {
+    snprintf(key, 16, "k%02lu", (unsigned long)i);
+}
+
+// True if the store holds exactly `model`
+static bool pf_matches(const pf_value_t* model) {
+    char key[16];
+    uint8_t buf[PF_VALUE_MAX];
+    for (uint32_t i = 0; i < PF_KEYS; i++) {
+        pf_key(key, i);
+        int n = flash_kv_get(key, buf, sizeof buf);
+        if (!model[i].present) {
+            if (n != FLASH_KV_NOT_FOUND) return false;
+        } else if (n != model[i].len || memcmp(buf, model[i].data, model[i].len) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Stage 1-4 changes and commit; false once the flash has lost power
+static bool pf_transaction(bool* in_commit) {
+    char key[16];
+    memcpy(inflight, committed, sizeof inflight);
+
+    uint32_t changes = 1 + host_rand() % 4;
+    for (uint32_t c = 0; c < changes; c++) {
+        uint32_t i = host_rand() % PF_KEYS;
+        pf_key(key, i);
+        int r;
+        if (inflight[i].present && host_rand() % 4 == 0) {
+            r = flash_kv_del(key);
+            inflight[i].present = false;
+        } else {
+            inflight[i].present = true;
+            inflight[i].len = (uint16_t)(1 + host_rand() % PF_VALUE_MAX);
+            fill(inflight[i].data, inflight[i].len);
+            r = flash_kv_put(key, inflight[i].data, inflight[i].len);
+        }
+        if (r) return false;
+    }
+
+    *in_commit = true;
+    if (flash_kv_commit()) return false;
+    *in_commit = false;
+    memcpy(committed, inflight, sizeof committed);
+
+    if (host_rand() % 8 == 0) {
+        while (flash_kv_maintain() > 0) {
+        }
+    }
+    return !flash_kv_sim_power_lost();
+}
+
+static int run_powerfail(const char* path, uint32_t cycles) {
+    if (flash_kv_sim_open(path) || flash_kv_format()) {
+        fprintf(stderr, "flash_kv_sim: cannot format %s\n", path);
+        return 1;
+    }
+    flash_kv_sim_seed(cycles);
+    memset(committed, 0, sizeof committed);
+
+    uint32_t failures = 0, torn_commits = 0, remounts = 0;
+    for (uint32_t cycle = 0; cycle < cycles; cycle++) {
+        flash_kv_sim_cut_after(1 + host_rand() % 64);
+        bool in_commit = false;
+        while (pf_transaction(&in_commit)) {
+        }
+
+        flash_kv_sim_power_on();
+        remounts++;
+        bool ok = flash_kv_mount() == FLASH_KV_OK;
+        // A commit cut short may land either way, but never half way
+        if (ok && pf_matches(committed)) {
+        } else if (ok && in_commit && pf_matches(inflight)) {
+            memcpy(committed, inflight, sizeof committed);
+            torn_commits++;
+        } else {
+            failures++;
+            printf("flash_kv_sim: cycle %lu: store does not match the last commit\n", (unsigned long)cycle);
+            // Carry on from what the store holds so later cycles still test something
+            if (flash_kv_format()) break;
+            memset(committed, 0, sizeof committed);
+        }
+    }
+
+    flash_kv_stats_t s;
+    flash_kv_get_stats(&s);
+    printf("{\"bench\":\"flash_kv_powerfail\",\"platform\":\"host-sim\",\"cycles\":%lu,\"remounts\":%lu,"
+           "\"failures\":%lu,\"commits_landed_at_cut\":%lu,\"erase_min\":%lu,\"erase_max\":%lu}\n",
+           (unsigned long)cycles, (unsigned long)remounts, (unsigned long)failures, (unsigned long)torn_commits,
+           (unsigned long)s.erase_min, (unsigned long)s.erase_max);
+
+    flash_kv_sim_close();
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && strcmp(argv[1], "bench") == 0) {
+        return run_bench(argv[2], argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 0) : 20000u);
+    }
+    if (argc >= 3 && strcmp(argv[1], "powerfail") == 0) {
+        return run_powerfail(argv[2], argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 0) : 1000u);
+    }
+    fprintf(stderr, "usage: %s bench <image> [ops]\n       %s powerfail <image> [cycles]\n", argv[0], argv[0]);
+    return 2;
+}
@@ -0,0 +1,117 @@
+#include "flash_kv_sim.h"
+#include "flash_kv.h"
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+static int image = -1;
+static uint32_t cut_countdown;
+static bool power_lost;
+static uint32_t rng = 1;
+static flash_kv_sim_stats_t sim_stats;
+
+static uint32_t sim_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+int flash_kv_sim_open(const char* path) {
+    flash_kv_sim_close();
+    image = open(path, O_RDWR | O_CREAT, 0644);
+    if (image < 0) return -1;
+
+    // Extend a new or short image with erased bytes
+    off_t size = lseek(image, 0, SEEK_END);
+    uint8_t erased[FLASH_KV_SECTOR_SIZE];
+    memset(erased, 0xFF, sizeof erased);
+    for (off_t at = size - size % FLASH_KV_SECTOR_SIZE; at < (off_t)FLASH_KV_SIZE; at += FLASH_KV_SECTOR_SIZE) {
+        if (at < size) continue;
+        if (pwrite(image, erased, sizeof erased, at) != (ssize_t)sizeof erased) return -1;
+    }
+    memset(&sim_stats, 0, sizeof sim_stats);
+    return 0;
+}
+
+void flash_kv_sim_close(void) {
+    if (image >= 0) close(image);
+    image = -1;
+}
+
+void flash_kv_sim_seed(uint32_t seed) {
+    rng = seed ? seed : 1;
+}
+
+void flash_kv_sim_cut_after(uint32_t n) {
+    cut_countdown = n;
+}
+
+bool flash_kv_sim_power_lost(void) {
+    return power_lost;
+}
+
+void flash_kv_sim_power_on(void) {
+    power_lost = false;
+    cut_countdown = 0;
+}
+
+void flash_kv_sim_get_stats(flash_kv_sim_stats_t* out) {
+    *out = sim_stats;
+}
+
+// True if this operation is the one the power cut lands in
+static bool sim_cut_now(void) {
+    return cut_countdown && --cut_countdown == 0;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Port
+
+int flash_kv_port_init(void) {
+    return image >= 0 && !power_lost ? 0 : -1;
+}
+
+int flash_kv_port_read(uint32_t offset, void* buf, uint32_t len) {
+    if (image < 0 || power_lost || offset + len > FLASH_KV_SIZE) return -1;
+    sim_stats.reads++;
+    return pread(image, buf, len, offset) == (ssize_t)len ? 0 : -1;
+}
+
+int flash_kv_port_program(uint32_t offset, const void* page) {
+    if (image < 0 || power_lost || offset % FLASH_KV_PAGE_SIZE || offset >= FLASH_KV_SIZE) return -1;
+
+    uint8_t cells[FLASH_KV_PAGE_SIZE];
+    if (pread(image, cells, sizeof cells, offset) != (ssize_t)sizeof cells) return -1;
+    const uint8_t* data = page;
+    uint32_t end = FLASH_KV_PAGE_SIZE;
+    bool cut = sim_cut_now();
+    if (cut) end = sim_rand() % FLASH_KV_PAGE_SIZE;
+    for (uint32_t i = 0; i < end; i++) cells[i] &= data[i];
+    // The byte being programmed when power went keeps a random part of its new zeros
+    if (cut) cells[end] &= data[end] | (uint8_t)sim_rand();
+
+    if (pwrite(image, cells, sizeof cells, offset) != (ssize_t)sizeof cells) return -1;
+    sim_stats.programs++;
+    sim_stats.busy_us += FLASH_KV_SIM_PROGRAM_US;
+    if (cut) power_lost = true;
+    return cut ? -1 : 0;
+}
+
+int flash_kv_port_erase(uint32_t offset) {
+    if (image < 0 || power_lost || offset % FLASH_KV_SECTOR_SIZE || offset >= FLASH_KV_SIZE) return -1;
+
+    uint8_t cells[FLASH_KV_SECTOR_SIZE];
+    if (pread(image, cells, sizeof cells, offset) != (ssize_t)sizeof cells) return -1;
+    uint32_t end = FLASH_KV_SECTOR_SIZE;
+    bool cut = sim_cut_now();
+    if (cut) end = sim_rand() % FLASH_KV_SECTOR_SIZE;
+    memset(cells, 0xFF, end);
+    if (cut) cells[end] |= (uint8_t)sim_rand();
+
+    if (pwrite(image, cells, sizeof cells, offset) != (ssize_t)sizeof cells) return -1;
+    sim_stats.erases++;
+    sim_stats.busy_us += FLASH_KV_SIM_ERASE_US;
+    if (cut) power_lost = true;
+    return cut ? -1 : 0;
+}
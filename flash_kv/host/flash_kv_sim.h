@@ -0,0 +1,51 @@
+#pragma once
+/**
+ * @file flash_kv_sim.h
+ * @brief File-backed NOR flash for running flash_kv on the host.
+ *
+ * Implements the flash_kv port on an image file of FLASH_KV_SIZE bytes.
+ * Programs can only clear bits, as on the real part, and misaligned
+ * programs or erases fail. A power cut can be armed to land part-way
+ * through a later program or erase: that operation is left torn and every
+ * flash access fails until flash_kv_sim_power_on().
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Typical W25Q16JV timings, charged to busy_us for every operation
+#define FLASH_KV_SIM_PROGRAM_US 400u
+#define FLASH_KV_SIM_ERASE_US   45000u
+
+/**
+ * @struct flash_kv_sim_stats_t
+ * @brief Operation counts since the image was opened.
+ *
+ * busy_us – time the flash would have been busy on target, i.e. how long a
+ *           core spent parked in RAM over all programs and erases
+ */
+typedef struct {
+    uint32_t reads;
+    uint32_t programs;
+    uint32_t erases;
+    uint64_t busy_us;
+} flash_kv_sim_stats_t;
+
+/// @brief Open or create the image; a new image starts erased. Returns 0 on success.
+int flash_kv_sim_open(const char* path);
+
+void flash_kv_sim_close(void);
+
+/// @brief Seed for the torn-write patterns.
+void flash_kv_sim_seed(uint32_t seed);
+
+/// @brief Cut power part-way through the `n`th program or erase from now (0 disarms).
+void flash_kv_sim_cut_after(uint32_t n);
+
+/// @brief True once an armed cut has happened.
+bool flash_kv_sim_power_lost(void);
+
+/// @brief Restore power (disarming any cut).
+void flash_kv_sim_power_on(void);
+
+void flash_kv_sim_get_stats(flash_kv_sim_stats_t* out);
@@ -0,0 +1,12 @@
+#include "pico/stdlib.h"
+#include "timebase.h"
+
+// Definitions behind the host stand-ins in include/, linked once into every
+// host program (ros_bench, os2_conformance, flash_kv_sim).
+
+volatile uint host_exception_number;
+
+void sleep_until(absolute_time_t t) {
+    while (timebase_now_us() < t) {
+    }
+}
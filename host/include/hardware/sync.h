@@ -0,0 +1,28 @@
+#pragma once
+/**
+ * @file hardware/sync.h
+ * @brief Host stand-in for the pico-sdk spin locks: the host build is single-threaded.
+ */
+
+#include "pico/stdlib.h"
+
+typedef volatile uint32_t spin_lock_t;
+
+static inline spin_lock_t* spin_lock_instance(uint lock_num) {
+    static spin_lock_t locks[32];
+    return &locks[lock_num];
+}
+
+static inline uint32_t spin_lock_blocking(spin_lock_t* lock) {
+    (void)lock;
+    return 0;
+}
+
+static inline void spin_unlock(spin_lock_t* lock, uint32_t saved_irq) {
+    (void)lock;
+    (void)saved_irq;
+}
+
+static inline void __dmb(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
@@ -0,0 +1,43 @@
+#pragma once
+/**
+ * @file pico/stdlib.h
+ * @brief Host stand-in for the few pico-sdk pieces the kernel sources use.
+ *
+ * Only the host builds (ros_bench, os2_conformance, flash_kv_sim) see this
+ * directory; each links host_support.c for the definitions. There is one
+ * thread and no interrupts; a host program sets the "exception number" while
+ * it runs the tick or a test interrupt so ISR-only paths behave as on target.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#define NUM_CORES            2
+#define PICO_ERROR_TIMEOUT   (-1)
+#define PICO_SPINLOCK_ID_OS1 22
+#define PICO_SPINLOCK_ID_OS2 23
+
+/// Exception number the host port pretends to be running (0 = thread mode)
+extern volatile uint host_exception_number;
+
+static inline uint __get_current_exception(void) {
+    return host_exception_number;
+}
+
+/// The host runs everything on "core 0"
+static inline uint get_core_num(void) {
+    return 0;
+}
+
+static inline absolute_time_t from_us_since_boot(uint64_t us) {
+    return us;
+}
+
+/// Busy-waits on timebase_now_us()
+void sleep_until(absolute_time_t t);
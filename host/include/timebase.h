@@ -0,0 +1,22 @@
+#pragma once
+/**
+ * @file timebase.h
+ * @brief Host stand-in for the timebase driver, backed by CLOCK_MONOTONIC.
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+static inline uint64_t timebase_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static inline uint32_t timebase_now_us32(void) {
+    return (uint32_t)timebase_now_us();
+}
+
+static inline uint64_t timebase_us_to_ms(uint64_t us) {
+    return us / 1000u;
+}
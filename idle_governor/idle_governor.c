@@ -0,0 +1,208 @@
+#include "idle_governor.h"
+#include "scheduler.h"
+#include "timebase.h"
+
+#include "hardware/timer.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "hardware/gpio.h"
+#include "hardware/xosc.h"
+#include "hardware/structs/scb.h"
+#include "pico/sleep.h"
+
+// Clocks that must survive clock-gated sleep for the timer wake-up to work
+#define IDLE_SLEEP_EN1_TIMER (CLOCKS_SLEEP_EN1_CLK_SYS_TIMER_BITS | CLOCKS_SLEEP_EN1_CLK_SYS_WATCHDOG_BITS)
+
+// Written by both cores, so every access holds the scheduler spinlock
+static idle_residency_t residency[IDLE_STATE_COUNT];
+
+// One alarm per core: its interrupt is enabled on the core that claimed it, so it wakes that core
+static int wake_alarm[NUM_CORES] = { -1, -1 };
+
+static uint8_t dormant_events[NUM_BANK0_GPIOS];   // GPIO_IRQ_* bits that wake each pin from dormant
+static uint32_t dormant_pins;                      // Pins with a dormant wake event
+static bool dormant_allowed = false;
+
+// Cores currently inside idle_governor_enter(); dormant stops both, so it needs both
+static volatile uint32_t idle_cores;
+
+static uint32_t keep_en0 = 0;
+static uint32_t keep_en1 = 0;
+static void (*clock_restore)(void) = NULL;
+
+static void idle_alarm_callback(uint alarm_num) {
+    // Nothing to do: the interrupt itself ends WFI/sleep
+    (void)alarm_num;
+}
+
+void idle_governor_init(void) {
+    uint core = get_core_num();
+    if (wake_alarm[core] < 0) {
+        wake_alarm[core] = hardware_alarm_claim_unused(true);
+        hardware_alarm_set_callback((uint)wake_alarm[core], idle_alarm_callback);
+    }
+    idle_governor_reset_stats();
+}
+
+void idle_governor_set_dormant_wake_pin(uint gpio, bool edge, bool high) {
+    uint8_t event = edge ? (high ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL)
+                         : (high ? GPIO_IRQ_LEVEL_HIGH : GPIO_IRQ_LEVEL_LOW);
+    uint32_t irq = save_and_disable_interrupts();
+    dormant_events[gpio] = event;
+    dormant_pins |= 1u << gpio;
+    restore_interrupts(irq);
+}
+
+void idle_governor_clear_dormant_wake_pins(void) {
+    uint32_t irq = save_and_disable_interrupts();
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++) dormant_events[gpio] = 0;
+    dormant_pins = 0;
+    restore_interrupts(irq);
+}
+
+void idle_governor_allow_dormant(bool allow) {
+    dormant_allowed = allow;
+}
+
+void idle_governor_keep_clocks(uint32_t en0, uint32_t en1) {
+    keep_en0 = en0;
+    keep_en1 = en1;
+}
+
+void idle_governor_set_clock_restore(void (*restore)(void)) {
+    clock_restore = restore;
+}
+
+void idle_governor_get_stats(idle_residency_t out[IDLE_STATE_COUNT]) {
+    uint32_t lock = spin_lock_blocking(spin_lock_instance(PICO_SPINLOCK_ID_OS1));
+    for (int i = 0; i < IDLE_STATE_COUNT; i++) out[i] = residency[i];
+    spin_unlock(spin_lock_instance(PICO_SPINLOCK_ID_OS1), lock);
+}
+
+void idle_governor_reset_stats(void) {
+    uint32_t lock = spin_lock_blocking(spin_lock_instance(PICO_SPINLOCK_ID_OS1));
+    for (int i = 0; i < IDLE_STATE_COUNT; i++) {
+        residency[i].entries = 0;
+        residency[i].time_us = 0;
+    }
+    spin_unlock(spin_lock_instance(PICO_SPINLOCK_ID_OS1), lock);
+}
+
+// Dormant stops every clock, so it must not cut off the other core or a wake source that needs one
+static bool idle_dormant_ok(void) {
+    if (!dormant_allowed || !dormant_pins) return false;
+    // Peripherals kept clocked in sleep are wake sources; dormant would silence them
+    if (keep_en0 || keep_en1) return false;
+    return idle_cores == 3u;
+}
+
+static idle_state_t idle_pick_state(uint64_t now, uint64_t deadline) {
+    if (deadline == UINT64_MAX) {
+        if (idle_dormant_ok()) return IDLE_STATE_DORMANT;
+        return IDLE_STATE_SLEEP;
+    }
+    if (deadline - now < IDLE_GOVERNOR_SLEEP_MIN_US) return IDLE_STATE_WFI;
+    return IDLE_STATE_SLEEP;
+}
+
+// Arm this core's wake-up alarm; returns false if the deadline has already passed
+static bool idle_arm_alarm(int alarm, uint64_t deadline) {
+    if (deadline == UINT64_MAX || alarm < 0) return true;
+    return !hardware_alarm_set_target((uint)alarm, from_us_since_boot(deadline));
+}
+
+static void idle_enter_sleep(void) {
+    uint32_t en0 = clocks_hw->sleep_en0;
+    uint32_t en1 = clocks_hw->sleep_en1;
+
+    clocks_hw->sleep_en0 = keep_en0;
+    clocks_hw->sleep_en1 = keep_en1 | IDLE_SLEEP_EN1_TIMER;
+    scb_hw->scr |= M0PLUS_SCR_SLEEPDEEP_BITS;
+
+    __wfi();
+
+    scb_hw->scr &= ~M0PLUS_SCR_SLEEPDEEP_BITS;
+    clocks_hw->sleep_en0 = en0;
+    clocks_hw->sleep_en1 = en1;
+}
+
+static void idle_enter_dormant(void) {
+    uint32_t scr = scb_hw->scr;
+    uint32_t en0 = clocks_hw->sleep_en0;
+    uint32_t en1 = clocks_hw->sleep_en1;
+
+    sleep_run_from_xosc();
+
+    // Any configured pin wakes the chip, as sleep_goto_dormant_until_pin() does for one
+    for (uint32_t pins = dormant_pins; pins; pins &= pins - 1) {
+        uint gpio = (uint)__builtin_ctz(pins);
+        gpio_set_dormant_irq_enabled(gpio, dormant_events[gpio], true);
+    }
+    xosc_dormant();
+    for (uint32_t pins = dormant_pins; pins; pins &= pins - 1) {
+        uint gpio = (uint)__builtin_ctz(pins);
+        gpio_set_dormant_irq_enabled(gpio, dormant_events[gpio], false);
+        gpio_acknowledge_irq(gpio, dormant_events[gpio]);
+    }
+
+    // XOSC is back; bring PLLs and clk_sys up again before anything else runs
+    scb_hw->scr = scr;
+    clocks_hw->sleep_en0 = en0;
+    clocks_hw->sleep_en1 = en1;
+    if (clock_restore) clock_restore();
+    else clocks_init();
+
+    // The timer was frozen, so it is still monotonic; only clk_sys may differ
+    timebase_calibrate();
+}
+
+void idle_governor_enter(void) {
+    // Interrupts stay masked from the ready check to the sleep instruction: an interrupt
+    // that readies a process in between is left pending, and a pending interrupt ends
+    // WFI even while masked. It runs once interrupts are restored below.
+    uint32_t irq = save_and_disable_interrupts();
+    uint core = get_core_num();
+    uint32_t core_bit = 1u << core;
+    int alarm = wake_alarm[core];
+    if (scheduler_has_ready()) {
+        restore_interrupts(irq);
+        return;
+    }
+
+    uint32_t lock = spin_lock_blocking(spin_lock_instance(PICO_SPINLOCK_ID_OS1));
+    idle_cores |= core_bit;
+    uint64_t now = timebase_now_us();
+    uint64_t deadline = scheduler_next_deadline_us();
+    idle_state_t state = idle_pick_state(now, deadline);
+    spin_unlock(spin_lock_instance(PICO_SPINLOCK_ID_OS1), lock);
+
+    if (state != IDLE_STATE_DORMANT && !idle_arm_alarm(alarm, deadline)) {
+        idle_cores &= ~core_bit;
+        restore_interrupts(irq);
+        return;
+    }
+
+    switch (state) {
+        case IDLE_STATE_WFI:
+            __wfi();
+            break;
+        case IDLE_STATE_SLEEP:
+            idle_enter_sleep();
+            break;
+        case IDLE_STATE_DORMANT:
+            idle_enter_dormant();
+            break;
+        default:
+            break;
+    }
+
+    if (alarm >= 0) hardware_alarm_cancel((uint)alarm);
+    uint64_t slept = state == IDLE_STATE_DORMANT ? 0 : timebase_now_us() - now;
+
+    lock = spin_lock_blocking(spin_lock_instance(PICO_SPINLOCK_ID_OS1));
+    idle_cores &= ~core_bit;
+    residency[state].entries++;
+    residency[state].time_us += slept;
+    spin_unlock(spin_lock_instance(PICO_SPINLOCK_ID_OS1), lock);
+    restore_interrupts(irq);
+}
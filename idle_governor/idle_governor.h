@@ -0,0 +1,118 @@
+#pragma once
+/**
+ * @file idle_governor.h
+ * @brief Power-aware idle task choosing WFI, clock-gated sleep, or dormant.
+ *
+ * When no process is runnable the governor looks at the next scheduler
+ * deadline and the configured wake sources, enters the deepest low-power
+ * state that still meets them, restores clocks and the timebase on wake,
+ * and keeps per-state residency statistics.
+ */
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Idle periods shorter than this use plain WFI (sleep entry/exit is not worth it)
+#ifndef IDLE_GOVERNOR_SLEEP_MIN_US
+#define IDLE_GOVERNOR_SLEEP_MIN_US 500u
+#endif
+
+/// @brief Low-power states selectable by the governor
+typedef enum {
+    IDLE_STATE_WFI,      // Core waits for interrupt, all clocks running
+    IDLE_STATE_SLEEP,    // Deep sleep with clk_sys gated to all but the timer and kept peripherals
+    IDLE_STATE_DORMANT,  // XOSC stopped, wakes only on the dormant wake pins
+    IDLE_STATE_COUNT
+} idle_state_t;
+
+/**
+ * @struct idle_residency_t
+ * @brief Residency statistics for one idle state.
+ *
+ * entries  – number of times the state was entered
+ * time_us  – total time spent in the state (timebase microseconds)
+ *
+ * The timer is stopped in dormant, so dormant time_us stays 0; only entries are counted.
+ */
+typedef struct {
+    uint32_t entries;
+    uint64_t time_us;
+} idle_residency_t;
+
+/**
+ * @brief Claim the calling core's wake-up alarm and reset statistics.
+ *
+ * Call it once on every core that idles through idle_governor_enter(): each
+ * core gets its own alarm, whose interrupt is enabled on that core.
+ * Kernel::init() and Kernel::launch_core1() do this.
+ */
+void idle_governor_init(void);
+
+/**
+ * @brief Run one idle decision: pick a state, enter it, and account for it on wake.
+ *
+ * Returns immediately if a process is already ready to run. Interrupts are
+ * masked from that check until the core wakes, so a process readied in
+ * between is not missed. Dormant is only chosen while both cores are in here,
+ * so both must idle through it (see Kernel::run()).
+ */
+void idle_governor_enter(void);
+
+/**
+ * @brief Add a GPIO that wakes the system from dormant (call once per pin).
+ *
+ * Dormant is only considered when a wake pin is configured, dormant is
+ * allowed, and no peripheral clocks are kept for sleep wake-ups
+ * (idle_governor_keep_clocks()), since dormant would stop them.
+ *
+ * @param gpio GPIO number.
+ * @param edge true for edge-triggered, false for level.
+ * @param high true for rising edge / high level, false for falling / low.
+ */
+void idle_governor_set_dormant_wake_pin(uint gpio, bool edge, bool high);
+
+/// @brief Remove every dormant wake pin.
+void idle_governor_clear_dormant_wake_pins(void);
+
+/**
+ * @brief Allow or forbid dormant mode (e.g. forbid while USB stdio is in use).
+ * @param allow true to allow dormant when nothing is scheduled.
+ */
+void idle_governor_allow_dormant(bool allow);
+
+/**
+ * @brief Keep extra peripheral clocks running during clock-gated sleep.
+ *
+ * Use this for peripherals that act as wake sources (e.g. UART RX).
+ * Masks use the CLOCKS_SLEEP_EN0/EN1 bit layout.
+ *
+ * @param en0 Extra bits for SLEEP_EN0.
+ * @param en1 Extra bits for SLEEP_EN1.
+ */
+void idle_governor_keep_clocks(uint32_t en0, uint32_t en1);
+
+/**
+ * @brief Override how clocks are restored after dormant (default: clocks_init()).
+ *
+ * If the restored clocks leave clk_peri at a different rate, call
+ * SPI_clockChanged() from here so the SPI baud is recomputed.
+ *
+ * @param restore Function reconfiguring PLLs and clk_sys, or NULL for the default.
+ */
+void idle_governor_set_clock_restore(void (*restore)(void));
+
+/**
+ * @brief Copy out the residency statistics, summed over both cores.
+ * @param out Array of IDLE_STATE_COUNT entries to fill.
+ */
+void idle_governor_get_stats(idle_residency_t out[IDLE_STATE_COUNT]);
+
+/// @brief Clear all residency statistics.
+void idle_governor_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
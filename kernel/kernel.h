@@ -8,15 +8,23 @@
 
 #include "pico/stdlib.h"
 #include "pico/multicore.h"
+#include "pico/flash.h"
 
 extern "C" {
     #include "scheduler.h"
+    #include "stack_guard.h"
 }
 
 extern "C" {
     #include "terminal_core.h"
 }
 
+#include "timebase.h"
+
+extern "C" {
+    #include "idle_governor.h"
+}
+
 namespace rohini {
 
 /**
@@ -25,14 +33,17 @@ namespace rohini {
 class Kernel {
 public:
     /**
-     * @brief Initialize clocks, USB STDIO, and the C scheduler.
+     * @brief Initialize clocks, USB STDIO, the timebase and the C scheduler.
      * 
      * Must be called on Core 0 before launching Core 1 or creating tasks.
      */
     static void init() {
         stdio_init_all();
+        timebase_calibrate();
         init_scheduler();
-
+        // Either core may program flash, so each one can be parked by the other
+        flash_safe_execute_core_init();
+        idle_governor_init();
     }
 
     /**
@@ -46,17 +57,45 @@ public:
     }
 
     /**
-     * @brief Launch the preemptive scheduler on Core 1.
+     * @brief Create a process with a scheduling priority.
      * 
-     * Core 1 will run its own loop; scheduling is driven by SysTick interrupts.
+     * Equivalent to `create_process()` in C.
+     * @param entry     Function pointer to the task entry.
+     * @param priority  Higher values are favored; equal priorities take turns.
+     * @return PID of the new process, or -1 if the process table is full.
+     */
+    static int create(void (*entry)(void), uint8_t priority) {
+        return create_process(entry, priority);
+    }
+
+    /**
+     * @brief Launch the scheduler loop (see run()) on Core 1.
      */
     static void launch_core1() {
         multicore_launch_core1([]() {
-            // Core 1 idles; SysTick_Handler will call schedule()
-            while (true) tight_loop_contents();
+            flash_safe_execute_core_init();
+            // Context switch exception priority and stack guard are per core
+            scheduler_core_init();
+            idle_governor_init();
+            run();
         });
     }
 
+    /**
+     * @brief Run the scheduler loop on the calling core; never returns.
+     * 
+     * Dispatches whatever is ready, then idles in the lowest power state the
+     * next deadline allows until an interrupt readies something. Core 0 calls
+     * this at the end of main(); dormant is only reachable while both cores
+     * idle here.
+     */
+    [[noreturn]] static void run() {
+        while (true) {
+            schedule();
+            idle_governor_enter();
+        }
+    }
+
     /**
      * @brief Yield execution to the next ready process.
      * 
@@ -66,6 +105,17 @@ public:
         schedule();
     }
 
+    /**
+     * @brief Sleep the current process for a number of microseconds.
+     * 
+     * The process is not runnable until the deadline passes, letting the
+     * idle governor pick a low-power state in the meantime.
+     * @param us  Microseconds to sleep.
+     */
+    static void delay_us(uint64_t us) {
+        process_sleep_until(timebase_now_us() + us);
+    }
+
     /**
      * @brief Fork the current process.
      * 
@@ -119,7 +169,8 @@ public:
     /**
      * @brief Entry point for the C++ task.
      * 
-     * Scheduler will invoke this method each time the process is dispatched.
+     * Runs once, on the process's own stack; the process exits when it
+     * returns, unless it called Kernel::exec().
      */
     virtual void run() = 0;
 
@@ -135,17 +186,35 @@ public:
         Kernel::create_init(&Process::entry_wrapper);
     }
 
+    /**
+     * @brief Entry point running `P.run()`, for a Process with static storage
+     *        declared in ROS_STATIC_TASKS (static_tasks.h) instead of spawned.
+     *
+     * Exits on return like a spawned process:
+     *
+     *   static SensorProcess sensor;
+     *   ROS_STATIC_TASKS(ROS_TASK(0, rohini::Process::entry<sensor>, 2));
+     */
+    template <auto& P>
+    static void entry() {
+        P.run();
+        if (process_table[scheduler_current_pid()].entry_point == &entry<P>)
+            Kernel::exit(0);
+    }
+
 private:
     static Process* instance_;
 
     /**
      * @brief Static wrapper to transition from C to C++.
      * 
-     * Invokes `instance_->run()` and exits automatically on return.
+     * Invokes `instance_->run()` and exits automatically on return, unless
+     * run() replaced the entry point with Kernel::exec(): that one runs next.
      */
     static void entry_wrapper() {
         instance_->run();
-        Kernel::exit(0);
+        if (process_table[scheduler_current_pid()].entry_point == &Process::entry_wrapper)
+            Kernel::exit(0);
     }
 };
 
@@ -14,11 +14,19 @@ add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/drivers/i2c_driver ${CMAKE_BINARY_DIR
 add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/drivers/spi_driver ${CMAKE_BINARY_DIR}/os/drivers/spi_driver)
 add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/drivers/serial_uart ${CMAKE_BINARY_DIR}/os/drivers/serial_uart)
 add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/drivers/sleep ${CMAKE_BINARY_DIR}/os/drivers/sleep)
+add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/drivers/timebase ${CMAKE_BINARY_DIR}/os/drivers/timebase)
+add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/drivers/adc_stream ${CMAKE_BINARY_DIR}/os/drivers/adc_stream)
 add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/kernel ${CMAKE_BINARY_DIR}/os/kernel)
 add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/scheduler ${CMAKE_BINARY_DIR}/os/scheduler)
+add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/idle_governor ${CMAKE_BINARY_DIR}/os/idle_governor)
+add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/ros_log ${CMAKE_BINARY_DIR}/os/ros_log)
 add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/svc_handler ${CMAKE_BINARY_DIR}/os/svc_handler)
+add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/telemetry ${CMAKE_BINARY_DIR}/os/telemetry)
 add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/terminal_core ${CMAKE_BINARY_DIR}/os/terminal_core)
 add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/terminal ${CMAKE_BINARY_DIR}/os/terminal)
+add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/workqueue ${CMAKE_BINARY_DIR}/os/workqueue)
+add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/flash_kv ${CMAKE_BINARY_DIR}/os/flash_kv)
+add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/coroutine ${CMAKE_BINARY_DIR}/os/coroutine)
 add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/include ${CMAKE_BINARY_DIR}/os/include)
 
 # Optional: tests or examples
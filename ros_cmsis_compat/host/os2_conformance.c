@@ -0,0 +1,511 @@
+#include "cmsis_os2.h"
+#include "scheduler.h"
+#include "ros_sync.h"
+#include "timebase.h"
+#include <stdio.h>
+#include <string.h>
+
+// CMSIS-RTOS2 conformance checks on the host. The cases run in one CMSIS
+// thread ("runner"); helper threads are created at a higher priority and run
+// when the runner yields, waits or delays, each on its own stack as on
+// target. The host has no tick and no interrupts: "ISR" checks set the
+// exception number the host shims report.
+//   os2_conformance        prints one line per failed check, exits non-zero if any failed
+
+#define HOST_IRQ_EXCEPTION 16
+
+static uint32_t checks, failures;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        checks++;                                           \
+        if (!(cond)) {                                      \
+            failures++;                                     \
+            printf("os2_conformance:%d: ", __LINE__);       \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+        }                                                   \
+    } while (0)
+
+static osThreadId_t runner;
+
+// A helper above the runner's priority, dispatched on the runner's next yield or wait.
+// Each one takes a process slot for good, hence MAX_PROCESSES=32 in the host build.
+static osThreadId_t helper(osThreadFunc_t func, void* arg) {
+    const osThreadAttr_t attr = { .name = "helper", .priority = osPriorityHigh };
+    osThreadId_t id = osThreadNew(func, arg, &attr);
+    CHECK(id != NULL, "helper: osThreadNew failed");
+    return id;
+}
+
+static uint64_t elapsed_us(uint64_t start) {
+    return timebase_now_us() - start;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Kernel
+
+static void test_kernel(void) {
+    osVersion_t version;
+    char id[16];
+    CHECK(osKernelGetInfo(&version, id, sizeof id) == osOK, "osKernelGetInfo failed");
+    CHECK(version.api == 20010003u, "API version %lu", (unsigned long)version.api);
+    CHECK(strcmp(id, "Rohini RTOS") == 0, "kernel ID \"%s\"", id);
+    CHECK(osKernelGetTickFreq() == 1000u, "tick frequency %lu", (unsigned long)osKernelGetTickFreq());
+    CHECK(osKernelGetSysTimerFreq() == 1000000u, "system timer frequency %lu",
+          (unsigned long)osKernelGetSysTimerFreq());
+
+    uint32_t tick = osKernelGetTickCount();
+    osDelay(3);
+    CHECK(osKernelGetTickCount() - tick >= 3, "tick count moved %lu over osDelay(3)",
+          (unsigned long)(osKernelGetTickCount() - tick));
+}
+
+static void test_kernel_lock(void) {
+    CHECK(osKernelLock() == 0, "first lock: not reported unlocked before");
+    CHECK(osKernelGetState() == osKernelLocked, "state %d while locked", osKernelGetState());
+    CHECK(osKernelLock() == 1, "nested lock: not reported locked before");
+    CHECK(osKernelUnlock() == 1, "first unlock: not reported locked before");
+    CHECK(osKernelUnlock() == 1, "second unlock: not reported locked before");
+    CHECK(osKernelUnlock() == 0, "extra unlock: not reported unlocked before");
+    CHECK(osKernelGetState() == osKernelRunning, "state %d after unlock", osKernelGetState());
+
+    CHECK(osKernelRestoreLock(1) == 1 && osKernelGetState() == osKernelLocked, "osKernelRestoreLock(1)");
+    CHECK(osKernelRestoreLock(0) == 0 && osKernelGetState() == osKernelRunning, "osKernelRestoreLock(0)");
+}
+
+// ─────────────────────────────────────────────────────────────
+// Threads
+
+static volatile int child_ran;
+static volatile int child_after_exit;
+static volatile osThreadId_t child_self;
+
+static void child_record(void* arg) {
+    child_self = osThreadGetId();
+    child_ran = (int)(intptr_t)arg;
+}
+
+static void child_exit(void* arg) {
+    (void)arg;
+    child_ran = 1;
+    osThreadExit();
+    child_after_exit = 1;
+}
+
+static void child_terminate_self(void* arg) {
+    (void)arg;
+    child_ran = 1;
+    osThreadTerminate(osThreadGetId());
+    child_after_exit = 1;
+}
+
+static void test_thread_create(void) {
+    CHECK(osThreadNew(NULL, NULL, NULL) == NULL, "NULL function accepted");
+    const osThreadAttr_t big = { .stack_size = 1u << 20 };
+    CHECK(osThreadNew(child_record, NULL, &big) == NULL, "oversized stack accepted");
+    const osThreadAttr_t bad_prio = { .priority = (osPriority_t)(osPriorityISR + 1) };
+    CHECK(osThreadNew(child_record, NULL, &bad_prio) == NULL, "priority above osPriorityISR accepted");
+
+    osThreadId_t self = osThreadGetId();
+    CHECK(self == runner, "osThreadGetId() is not the runner");
+    CHECK(osThreadGetState(self) == osThreadRunning, "own state %d", osThreadGetState(self));
+    CHECK(osThreadGetPriority(self) == osPriorityNormal, "own priority %d", osThreadGetPriority(self));
+    CHECK(strcmp(osThreadGetName(self), "runner") == 0, "own name");
+
+    child_ran = 0;
+    osThreadId_t child = helper(child_record, (void*)(intptr_t)42);
+    CHECK(osThreadGetState(child) == osThreadReady, "new thread state %d", osThreadGetState(child));
+    CHECK(strcmp(osThreadGetName(child), "helper") == 0, "new thread name");
+    CHECK(osThreadYield() == osOK, "osThreadYield failed");
+    CHECK(child_ran == 42, "thread did not run with its argument");
+    CHECK(child_self == child, "osThreadGetId() inside the thread is not its ID");
+    CHECK(osThreadGetState(child) == osThreadTerminated, "returned thread state %d", osThreadGetState(child));
+}
+
+static void test_thread_exit(void) {
+    child_ran = child_after_exit = 0;
+    osThreadId_t child = helper(child_exit, NULL);
+    osThreadYield();
+    CHECK(child_ran && !child_after_exit, "osThreadExit() returned to the thread");
+    CHECK(osThreadGetState(child) == osThreadTerminated, "exited thread state %d", osThreadGetState(child));
+
+    child_ran = child_after_exit = 0;
+    child = helper(child_terminate_self, NULL);
+    osThreadYield();
+    CHECK(child_ran && !child_after_exit, "osThreadTerminate(self) returned to the thread");
+    CHECK(osThreadGetState(child) == osThreadTerminated, "self-terminated thread state %d",
+          osThreadGetState(child));
+
+    // The runner is still dispatched and running after both
+    CHECK(osThreadGetState(runner) == osThreadRunning, "runner state %d", osThreadGetState(runner));
+}
+
+static void test_thread_control(void) {
+    const osThreadAttr_t low = { .priority = osPriorityLow };
+    child_ran = 0;
+    osThreadId_t child = osThreadNew(child_record, (void*)1, &low);
+
+    CHECK(osThreadSetPriority(child, osPriorityHigh) == osOK, "osThreadSetPriority failed");
+    CHECK(osThreadGetPriority(child) == osPriorityHigh, "priority %d after set", osThreadGetPriority(child));
+    CHECK(osThreadSetPriority(child, (osPriority_t)(osPriorityISR + 1)) == osErrorParameter,
+          "invalid priority accepted");
+
+    // Suspended threads are not dispatched until resumed
+    CHECK(osThreadSuspend(child) == osOK, "osThreadSuspend failed");
+    CHECK(osThreadGetState(child) == osThreadBlocked, "suspended state %d", osThreadGetState(child));
+    osThreadYield();
+    CHECK(child_ran == 0, "suspended thread ran");
+    CHECK(osThreadResume(child) == osOK, "osThreadResume failed");
+    CHECK(osThreadResume(child) == osErrorResource, "resume of a ready thread accepted");
+    osThreadYield();
+    CHECK(child_ran == 1, "resumed thread did not run");
+
+    // Terminate before it ever runs
+    child_ran = 0;
+    child = osThreadNew(child_record, (void*)1, &low);
+    uint32_t count = osThreadGetCount();
+    osThreadId_t ids[MAX_PROCESSES];
+    uint32_t listed = osThreadEnumerate(ids, MAX_PROCESSES);
+    CHECK(listed == count, "osThreadEnumerate listed %lu of %lu", (unsigned long)listed, (unsigned long)count);
+    CHECK(osThreadTerminate(child) == osOK, "osThreadTerminate failed");
+    CHECK(osThreadTerminate(child) == osErrorResource, "second osThreadTerminate accepted");
+    CHECK(osThreadGetCount() == count - 1, "count %lu after terminate, expected %lu",
+          (unsigned long)osThreadGetCount(), (unsigned long)(count - 1));
+    osThreadYield();
+    CHECK(child_ran == 0, "terminated thread ran");
+
+    // Join blocks until the thread has finished
+    child_ran = 0;
+    child = helper(child_record, (void*)7);
+    CHECK(osThreadJoin(child) == osOK && child_ran == 7, "osThreadJoin did not wait for the thread");
+    CHECK(osThreadJoin(runner) == osErrorParameter, "join on self accepted");
+}
+
+// ─────────────────────────────────────────────────────────────
+// Thread flags
+
+static void child_set_flags(void* arg) {
+    osThreadFlagsSet((osThreadId_t)arg, 0x10);
+}
+
+static void test_thread_flags(void) {
+    osThreadFlagsClear(0x7FFFFFFFu);
+    CHECK(osThreadFlagsSet(runner, 0x3) == 0x3, "set returned wrong flags");
+    CHECK(osThreadFlagsGet() == 0x3, "get %lx", (unsigned long)osThreadFlagsGet());
+    CHECK(osThreadFlagsClear(0x1) == 0x3, "clear did not return the flags before");
+    CHECK(osThreadFlagsGet() == 0x2, "get %lx after clear", (unsigned long)osThreadFlagsGet());
+    CHECK(osThreadFlagsWait(0x2, osFlagsWaitAny, 0) == 0x2, "wait for a set flag");
+    CHECK(osThreadFlagsGet() == 0, "wait did not clear the flag");
+    CHECK(osThreadFlagsWait(0x4, osFlagsWaitAny, 0) == osFlagsErrorResource, "try-wait on a clear flag");
+    CHECK(osThreadFlagsSet(runner, osFlagsError) == osFlagsErrorParameter, "error bit accepted");
+
+    uint64_t start = timebase_now_us();
+    CHECK(osThreadFlagsWait(0x4, osFlagsWaitAny, 5) == osFlagsErrorTimeout, "timed wait did not time out");
+    CHECK(elapsed_us(start) >= 5000, "timed wait returned after %llu us", (unsigned long long)elapsed_us(start));
+
+    // Another thread sets the flag while the runner waits forever
+    osThreadId_t setter = helper(child_set_flags, runner);
+    CHECK(setter && osThreadFlagsWait(0x10, osFlagsWaitAny, osWaitForever) == 0x10, "flag set by another thread missed");
+}
+
+// ─────────────────────────────────────────────────────────────
+// Event flags
+
+static void test_event_flags(void) {
+    osEventFlagsId_t ef = osEventFlagsNew(NULL);
+    CHECK(ef != NULL, "osEventFlagsNew failed");
+    CHECK(osEventFlagsSet(ef, 0x5) == 0x5, "set returned wrong flags");
+    CHECK(osEventFlagsWait(ef, 0x5, osFlagsWaitAll, 0) == 0x5, "wait-all on set flags");
+    CHECK(osEventFlagsGet(ef) == 0, "wait-all did not clear");
+    osEventFlagsSet(ef, 0x1);
+    CHECK(osEventFlagsWait(ef, 0x3, osFlagsWaitAll, 0) == osFlagsErrorResource, "wait-all with one flag missing");
+    CHECK(osEventFlagsWait(ef, 0x3, osFlagsWaitAny | osFlagsNoClear, 0) == 0x1, "wait-any no-clear");
+    CHECK(osEventFlagsGet(ef) == 0x1, "no-clear cleared");
+    CHECK(osEventFlagsClear(ef, 0x1) == 0x1, "clear did not return the flags before");
+    CHECK(osEventFlagsSet(ef, osFlagsError) == osFlagsErrorParameter, "error bit accepted");
+    CHECK(osEventFlagsSet(NULL, 1) == osFlagsErrorParameter, "NULL ID accepted");
+    CHECK(osEventFlagsDelete(ef) == osOK, "delete failed");
+
+    ros_event_flags_t cb;
+    const osEventFlagsAttr_t small = { .cb_mem = &cb, .cb_size = sizeof cb - 1 };
+    CHECK(osEventFlagsNew(&small) == NULL, "undersized cb_mem accepted");
+    const osEventFlagsAttr_t fits = { .cb_mem = &cb, .cb_size = sizeof cb };
+    CHECK(osEventFlagsNew(&fits) == &cb, "cb_mem not used as the control block");
+}
+
+// ─────────────────────────────────────────────────────────────
+// Mutex
+
+static volatile osStatus_t child_status;
+
+static void child_try_mutex(void* arg) {
+    child_status = osMutexAcquire((osMutexId_t)arg, 0);
+}
+
+static void child_wait_mutex(void* arg) {
+    child_status = osMutexAcquire((osMutexId_t)arg, 5);
+}
+
+static void test_mutex(void) {
+    osMutexId_t m = osMutexNew(NULL);
+    CHECK(m != NULL, "osMutexNew failed");
+    CHECK(osMutexAcquire(m, 0) == osOK, "acquire of a free mutex");
+    CHECK(osMutexGetOwner(m) == runner, "owner is not the runner");
+    CHECK(osMutexAcquire(m, 0) == osErrorResource, "non-recursive mutex taken twice");
+
+    helper(child_try_mutex, m);
+    osThreadYield();
+    CHECK(child_status == osErrorResource, "try-acquire of a held mutex: %d", child_status);
+
+    // The runner keeps the mutex while joined to the waiter, so only the timeout ends the wait
+    osThreadId_t waiter = helper(child_wait_mutex, m);
+    osThreadYield();
+    CHECK(osThreadGetState(waiter) == osThreadBlocked, "waiter state %d", osThreadGetState(waiter));
+    osThreadJoin(waiter);
+    CHECK(child_status == osErrorTimeout, "timed acquire of a held mutex: %d", child_status);
+
+    CHECK(osMutexRelease(m) == osOK, "release by the owner");
+    CHECK(osMutexRelease(m) == osErrorResource, "release of a free mutex");
+    CHECK(osMutexGetOwner(m) == NULL, "owner after release");
+    CHECK(osMutexDelete(m) == osOK, "delete failed");
+
+    const osMutexAttr_t rec = { .attr_bits = osMutexRecursive };
+    m = osMutexNew(&rec);
+    CHECK(osMutexAcquire(m, 0) == osOK && osMutexAcquire(m, 0) == osOK, "recursive acquire");
+    CHECK(osMutexRelease(m) == osOK && osMutexGetOwner(m) == runner, "first recursive release");
+    CHECK(osMutexRelease(m) == osOK && osMutexGetOwner(m) == NULL, "last recursive release");
+    CHECK(osMutexRelease(m) == osErrorResource, "release past the recursion depth");
+    osMutexDelete(m);
+}
+
+// ─────────────────────────────────────────────────────────────
+// Semaphore
+
+static void child_release(void* arg) {
+    osSemaphoreRelease((osSemaphoreId_t)arg);
+}
+
+static void test_semaphore(void) {
+    CHECK(osSemaphoreNew(0, 0, NULL) == NULL, "max_count 0 accepted");
+    CHECK(osSemaphoreNew(1, 2, NULL) == NULL, "initial above max accepted");
+
+    osSemaphoreId_t s = osSemaphoreNew(2, 1, NULL);
+    CHECK(s != NULL && osSemaphoreGetCount(s) == 1, "initial count");
+    CHECK(osSemaphoreAcquire(s, 0) == osOK, "acquire with a token");
+    CHECK(osSemaphoreAcquire(s, 0) == osErrorResource, "try-acquire without a token");
+
+    uint64_t start = timebase_now_us();
+    CHECK(osSemaphoreAcquire(s, 5) == osErrorTimeout, "timed acquire did not time out");
+    CHECK(elapsed_us(start) >= 5000, "timed acquire returned after %llu us", (unsigned long long)elapsed_us(start));
+
+    CHECK(osSemaphoreRelease(s) == osOK && osSemaphoreRelease(s) == osOK, "release up to max");
+    CHECK(osSemaphoreRelease(s) == osErrorResource, "release past max");
+    CHECK(osSemaphoreGetCount(s) == 2, "count %lu at max", (unsigned long)osSemaphoreGetCount(s));
+
+    // Another thread releases while the runner waits forever
+    osSemaphoreAcquire(s, 0);
+    osSemaphoreAcquire(s, 0);
+    osThreadId_t releaser = helper(child_release, s);
+    CHECK(releaser && osSemaphoreAcquire(s, osWaitForever) == osOK, "release by another thread missed");
+    CHECK(osSemaphoreDelete(s) == osOK, "delete failed");
+}
+
+// ─────────────────────────────────────────────────────────────
+// Memory pool
+
+static void test_memory_pool(void) {
+    CHECK(osMemoryPoolNew(0, 16, NULL) == NULL, "zero blocks accepted");
+
+    osMemoryPoolId_t mp = osMemoryPoolNew(4, 12, NULL);
+    CHECK(mp != NULL, "osMemoryPoolNew failed");
+    CHECK(osMemoryPoolGetCapacity(mp) == 4 && osMemoryPoolGetBlockSize(mp) == 12, "capacity or block size");
+
+    void* blocks[4];
+    for (int i = 0; i < 4; i++) {
+        blocks[i] = osMemoryPoolAlloc(mp, 0);
+        CHECK(blocks[i] != NULL, "alloc %d failed", i);
+        memset(blocks[i], 0xA5, 12);
+    }
+    CHECK(blocks[0] != blocks[1] && blocks[1] != blocks[2] && blocks[2] != blocks[3], "blocks overlap");
+    CHECK(osMemoryPoolGetCount(mp) == 4 && osMemoryPoolGetSpace(mp) == 0, "count or space when full");
+    CHECK(osMemoryPoolAlloc(mp, 0) == NULL, "alloc from an empty pool");
+
+    uint64_t start = timebase_now_us();
+    CHECK(osMemoryPoolAlloc(mp, 5) == NULL && elapsed_us(start) >= 5000, "timed alloc");
+
+    CHECK(osMemoryPoolFree(mp, blocks[2]) == osOK, "free failed");
+    CHECK(osMemoryPoolFree(mp, NULL) == osErrorParameter, "free of NULL accepted");
+    CHECK(osMemoryPoolFree(mp, (uint8_t*)blocks[0] + 1) == osErrorParameter, "free of a misaligned pointer accepted");
+    CHECK(osMemoryPoolAlloc(mp, 0) == blocks[2], "freed block not handed out again");
+    CHECK(osMemoryPoolDelete(mp) == osOK, "delete failed");
+
+    static uint32_t mem[4 * 4];
+    const osMemoryPoolAttr_t attr = { .mp_mem = mem, .mp_size = sizeof mem };
+    mp = osMemoryPoolNew(4, 16, &attr);
+    void* b = osMemoryPoolAlloc(mp, 0);
+    CHECK((uint8_t*)b >= (uint8_t*)mem && (uint8_t*)b < (uint8_t*)mem + sizeof mem, "mp_mem not used for blocks");
+    osMemoryPoolDelete(mp);
+}
+
+// ─────────────────────────────────────────────────────────────
+// Message queue
+
+static void child_put(void* arg) {
+    uint32_t v = 0xC0FFEE;
+    osMessageQueuePut((osMessageQueueId_t)arg, &v, 0, 0);
+}
+
+static void test_message_queue(void) {
+    CHECK(osMessageQueueNew(0, 4, NULL) == NULL, "zero messages accepted");
+
+    osMessageQueueId_t q = osMessageQueueNew(3, sizeof(uint32_t), NULL);
+    CHECK(q != NULL, "osMessageQueueNew failed");
+    CHECK(osMessageQueueGetCapacity(q) == 3 && osMessageQueueGetMsgSize(q) == 4, "capacity or message size");
+
+    for (uint32_t v = 1; v <= 3; v++) CHECK(osMessageQueuePut(q, &v, 0, 0) == osOK, "put %lu", (unsigned long)v);
+    uint32_t extra = 4;
+    CHECK(osMessageQueuePut(q, &extra, 0, 0) == osErrorResource, "put into a full queue");
+    CHECK(osMessageQueueGetCount(q) == 3 && osMessageQueueGetSpace(q) == 0, "count or space when full");
+
+    uint64_t start = timebase_now_us();
+    CHECK(osMessageQueuePut(q, &extra, 0, 5) == osErrorTimeout && elapsed_us(start) >= 5000, "timed put");
+
+    for (uint32_t want = 1; want <= 3; want++) {
+        uint32_t v = 0;
+        uint8_t prio = 0xFF;
+        CHECK(osMessageQueueGet(q, &v, &prio, 0) == osOK && v == want && prio == 0, "get %lu: %lu",
+              (unsigned long)want, (unsigned long)v);
+    }
+    uint32_t v;
+    CHECK(osMessageQueueGet(q, &v, NULL, 0) == osErrorResource, "get from an empty queue");
+
+    osMessageQueuePut(q, &extra, 0, 0);
+    CHECK(osMessageQueueReset(q) == osOK && osMessageQueueGetCount(q) == 0, "reset");
+
+    // Another thread puts while the runner waits forever
+    osThreadId_t producer = helper(child_put, q);
+    CHECK(producer && osMessageQueueGet(q, &v, NULL, osWaitForever) == osOK && v == 0xC0FFEE, "put by another thread missed");
+    CHECK(osMessageQueueDelete(q) == osOK, "delete failed");
+}
+
+// ─────────────────────────────────────────────────────────────
+// Two threads waiting forever on each other through one queue
+
+#define PC_MESSAGES 6
+
+static volatile uint32_t consumed_count, consumed_sum;
+
+static void pc_producer(void* arg) {
+    for (uint32_t v = 1; v <= PC_MESSAGES; v++) {
+        osMessageQueuePut((osMessageQueueId_t)arg, &v, 0, osWaitForever);
+        if (v % 2) osDelay(1);
+    }
+}
+
+static void pc_consumer(void* arg) {
+    for (int i = 0; i < PC_MESSAGES; i++) {
+        uint32_t v;
+        if (osMessageQueueGet((osMessageQueueId_t)arg, &v, NULL, osWaitForever) != osOK) return;
+        consumed_count++;
+        consumed_sum += v;
+    }
+}
+
+static void run_pair(osPriority_t producer_priority, osPriority_t consumer_priority) {
+    osMessageQueueId_t q = osMessageQueueNew(2, sizeof(uint32_t), NULL);
+    const osThreadAttr_t producer_attr = { .name = "producer", .priority = producer_priority };
+    const osThreadAttr_t consumer_attr = { .name = "consumer", .priority = consumer_priority };
+    consumed_count = consumed_sum = 0;
+
+    osThreadId_t producer = osThreadNew(pc_producer, q, &producer_attr);
+    osThreadId_t consumer = osThreadNew(pc_consumer, q, &consumer_attr);
+    CHECK(producer && consumer, "producer or consumer not created");
+    CHECK(osThreadJoin(consumer) == osOK && osThreadJoin(producer) == osOK, "join of the pair");
+    CHECK(consumed_count == PC_MESSAGES && consumed_sum == PC_MESSAGES * (PC_MESSAGES + 1) / 2,
+          "consumer got %lu messages summing to %lu", (unsigned long)consumed_count, (unsigned long)consumed_sum);
+    osMessageQueueDelete(q);
+}
+
+static void test_producer_consumer(void) {
+    // The consumer waits forever on an empty queue while the lower producer fills it
+    run_pair(osPriorityBelowNormal, osPriorityAboveNormal);
+    // The producer waits forever on a full queue while the lower consumer drains it
+    run_pair(osPriorityAboveNormal, osPriorityBelowNormal);
+}
+
+// ─────────────────────────────────────────────────────────────
+// Delay and interrupt context
+
+static void test_delay(void) {
+    CHECK(osDelay(0) == osErrorParameter, "osDelay(0) accepted");
+
+    uint64_t start = timebase_now_us();
+    CHECK(osDelay(2) == osOK && elapsed_us(start) >= 2000, "osDelay(2) returned after %llu us",
+          (unsigned long long)elapsed_us(start));
+
+    start = timebase_now_us();
+    CHECK(osDelayUntil(osKernelGetTickCount() + 3) == osOK && elapsed_us(start) >= 2000, "osDelayUntil(+3)");
+    CHECK(osDelayUntil(osKernelGetTickCount()) == osErrorParameter, "osDelayUntil(now) accepted");
+}
+
+static void test_isr(void) {
+    osSemaphoreId_t s = osSemaphoreNew(2, 1, NULL);
+    osMessageQueueId_t q = osMessageQueueNew(2, sizeof(uint32_t), NULL);
+    osMutexId_t m = osMutexNew(NULL);
+    uint32_t v = 1;
+
+    host_exception_number = HOST_IRQ_EXCEPTION;
+    CHECK(osKernelInitialize() == osErrorISR, "osKernelInitialize from an ISR");
+    CHECK(osThreadNew(child_record, NULL, NULL) == NULL, "osThreadNew from an ISR");
+    CHECK(osDelay(1) == osErrorISR, "osDelay from an ISR");
+    CHECK(osMutexAcquire(m, 0) == osErrorISR, "osMutexAcquire from an ISR");
+    CHECK(osThreadFlagsWait(1, osFlagsWaitAny, 0) == osFlagsErrorISR, "osThreadFlagsWait from an ISR");
+    CHECK(osSemaphoreAcquire(s, 10) == osErrorParameter, "blocking acquire from an ISR");
+    CHECK(osSemaphoreAcquire(s, 0) == osOK, "try-acquire from an ISR");
+    CHECK(osSemaphoreRelease(s) == osOK, "release from an ISR");
+    CHECK(osMessageQueuePut(q, &v, 0, 0) == osOK, "put from an ISR");
+    CHECK(osMessageQueuePut(q, &v, 0, 10) == osErrorParameter, "blocking put from an ISR");
+    CHECK(osThreadFlagsSet(runner, 0x1) == 0x1, "osThreadFlagsSet from an ISR");
+    host_exception_number = 0;
+
+    osThreadFlagsClear(0x1);
+    osSemaphoreDelete(s);
+    osMessageQueueDelete(q);
+    osMutexDelete(m);
+}
+
+static void run_cases(void* arg) {
+    (void)arg;
+    test_kernel();
+    test_kernel_lock();
+    test_thread_create();
+    test_thread_exit();
+    test_thread_control();
+    test_thread_flags();
+    test_event_flags();
+    test_mutex();
+    test_semaphore();
+    test_memory_pool();
+    test_message_queue();
+    test_producer_consumer();
+    test_delay();
+    test_isr();
+}
+
+int main(void) {
+    CHECK(osKernelGetState() == osKernelInactive, "state %d before osKernelInitialize", osKernelGetState());
+    CHECK(osKernelInitialize() == osOK, "osKernelInitialize failed");
+    CHECK(osKernelInitialize() == osError, "second osKernelInitialize accepted");
+    CHECK(osKernelGetState() == osKernelReady, "state %d after osKernelInitialize", osKernelGetState());
+
+    const osThreadAttr_t attr = { .name = "runner", .priority = osPriorityNormal };
+    runner = osThreadNew(run_cases, NULL, &attr);
+    CHECK(runner != NULL, "runner not created");
+
+    // What osKernelStart() does, until the runner has finished
+    while (runner && osThreadGetState(runner) != osThreadTerminated) schedule();
+
+    printf("os2_conformance: %lu checks, %lu failed\n", (unsigned long)checks, (unsigned long)failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,646 @@
+#include "cmsis_os2.h"
+#include "scheduler.h"
+#include "ros_sync.h"
+#include "timebase.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+/// Control blocks available when attr->cb_mem is not given
+#ifndef ROS_OS2_MAX_EVENT_FLAGS
+#define ROS_OS2_MAX_EVENT_FLAGS 8
+#endif
+#ifndef ROS_OS2_MAX_MUTEXES
+#define ROS_OS2_MAX_MUTEXES 8
+#endif
+#ifndef ROS_OS2_MAX_SEMAPHORES
+#define ROS_OS2_MAX_SEMAPHORES 8
+#endif
+#ifndef ROS_OS2_MAX_MEMORY_POOLS
+#define ROS_OS2_MAX_MEMORY_POOLS 4
+#endif
+#ifndef ROS_OS2_MAX_MESSAGE_QUEUES
+#define ROS_OS2_MAX_MESSAGE_QUEUES 4
+#endif
+
+/// Queue and pool storage when attr->mq_mem / attr->mp_mem is not given (never reclaimed)
+#ifndef ROS_OS2_DATA_ARENA_BYTES
+#define ROS_OS2_DATA_ARENA_BYTES 4096
+#endif
+
+#define OS2_API_VERSION    20010003u   // CMSIS-RTOS2 API 2.1.3
+#define OS2_KERNEL_VERSION 20003u      // Rohini RTOS 0.2.3
+#define OS2_TICK_HZ        1000u
+
+#define OS2_IN_ISR() (__get_current_exception() != 0)
+
+// Guards the static tables and the arena across cores
+#define OS2_LOCK() spin_lock_blocking(spin_lock_instance(PICO_SPINLOCK_ID_OS2))
+#define OS2_UNLOCK(irq) spin_unlock(spin_lock_instance(PICO_SPINLOCK_ID_OS2), irq)
+
+// ─────────────────────────────────────────────────────────────
+// Static control blocks
+
+#define OS2_TABLE(type, name, count) \
+    static type name[count];         \
+    static uint32_t name##_used;     \
+    _Static_assert((count) <= 32, #name " allocation mask holds 32 entries")
+
+OS2_TABLE(ros_event_flags_t, os2_event_flags, ROS_OS2_MAX_EVENT_FLAGS);
+OS2_TABLE(ros_mutex_t, os2_mutexes, ROS_OS2_MAX_MUTEXES);
+OS2_TABLE(ros_sem_t, os2_semaphores, ROS_OS2_MAX_SEMAPHORES);
+OS2_TABLE(ros_pool_t, os2_pools, ROS_OS2_MAX_MEMORY_POOLS);
+OS2_TABLE(ros_queue_t, os2_queues, ROS_OS2_MAX_MESSAGE_QUEUES);
+
+static uint8_t os2_arena[ROS_OS2_DATA_ARENA_BYTES] __attribute__((aligned(8)));
+static uint32_t os2_arena_used;
+
+// Claim a free entry of a static table, or NULL if all are taken
+static void* os2_table_alloc(void* table, uint32_t* used, uint32_t count, size_t size) {
+    void* entry = NULL;
+    uint32_t irq = OS2_LOCK();
+    for (uint32_t i = 0; i < count; i++) {
+        if (!(*used & (1u << i))) {
+            *used |= 1u << i;
+            entry = (uint8_t*)table + i * size;
+            break;
+        }
+    }
+    OS2_UNLOCK(irq);
+    return entry;
+}
+
+// Return an entry to its table; objects in caller memory are left alone
+static void os2_table_free(void* table, uint32_t* used, uint32_t count, size_t size, void* entry) {
+    uintptr_t offset = (uintptr_t)entry - (uintptr_t)table;
+    if ((uintptr_t)entry < (uintptr_t)table || offset >= count * size) return;
+
+    uint32_t irq = OS2_LOCK();
+    *used &= ~(1u << (offset / size));
+    OS2_UNLOCK(irq);
+}
+
+#define OS2_ALLOC(name, attr)                                                                         \
+    ((attr) && (attr)->cb_mem ? ((attr)->cb_size >= sizeof(name[0]) ? (attr)->cb_mem : NULL)          \
+                              : os2_table_alloc(name, &name##_used, sizeof(name) / sizeof(name[0]), \
+                                                sizeof(name[0])))
+#define OS2_FREE(name, obj) os2_table_free(name, &name##_used, sizeof(name) / sizeof(name[0]), sizeof(name[0]), obj)
+
+static void* os2_arena_alloc(uint32_t size) {
+    void* mem = NULL;
+    size = (size + 7u) & ~7u;
+    uint32_t irq = OS2_LOCK();
+    if (size <= ROS_OS2_DATA_ARENA_BYTES - os2_arena_used) {
+        mem = &os2_arena[os2_arena_used];
+        os2_arena_used += size;
+    }
+    OS2_UNLOCK(irq);
+    return mem;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Timeout and status conversion
+
+static inline uint64_t os2_timeout_us(uint32_t ticks) {
+    return ticks == osWaitForever ? ROS_WAIT_FOREVER : (uint64_t)ticks * (1000000u / OS2_TICK_HZ);
+}
+
+static inline osStatus_t os2_wait_failed(uint32_t timeout) {
+    return timeout == 0 ? osErrorResource : osErrorTimeout;
+}
+
+static inline uint32_t os2_flags_wait_failed(uint32_t timeout) {
+    return timeout == 0 ? osFlagsErrorResource : osFlagsErrorTimeout;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Kernel
+
+static volatile osKernelState_t os2_state = osKernelInactive;
+
+osStatus_t osKernelInitialize(void) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    if (os2_state != osKernelInactive) return osError;
+    init_scheduler();
+    os2_state = osKernelReady;
+    return osOK;
+}
+
+osStatus_t osKernelGetInfo(osVersion_t* version, char* id_buf, uint32_t id_size) {
+    if (version) {
+        version->api = OS2_API_VERSION;
+        version->kernel = OS2_KERNEL_VERSION;
+    }
+    if (id_buf && id_size) {
+        strncpy(id_buf, "Rohini RTOS", id_size - 1);
+        id_buf[id_size - 1] = '\0';
+    }
+    return osOK;
+}
+
+osKernelState_t osKernelGetState(void) {
+    return os2_state;
+}
+
+osStatus_t osKernelStart(void) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    if (os2_state != osKernelReady) return osError;
+    os2_state = osKernelRunning;
+    // The dispatcher loop, in thread mode on the boot stack; it runs while no thread is ready
+    while (true) schedule();
+}
+
+int32_t osKernelLock(void) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    int32_t was = scheduler_lock() ? 1 : 0;
+    os2_state = osKernelLocked;
+    return was;
+}
+
+int32_t osKernelUnlock(void) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    uint32_t depth = scheduler_unlock();
+    if (depth <= 1) os2_state = osKernelRunning;
+    return depth ? 1 : 0;
+}
+
+int32_t osKernelRestoreLock(int32_t lock) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    if (lock) return osKernelLock() >= 0 ? 1 : osError;
+    return osKernelUnlock() >= 0 ? 0 : osError;
+}
+
+uint32_t osKernelGetTickCount(void) {
+    return (uint32_t)timebase_us_to_ms(timebase_now_us());
+}
+
+uint32_t osKernelGetTickFreq(void) {
+    return OS2_TICK_HZ;
+}
+
+uint32_t osKernelGetSysTimerCount(void) {
+    return timebase_now_us32();
+}
+
+uint32_t osKernelGetSysTimerFreq(void) {
+    return 1000000u;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Threads (one per process_t; the ID is the process_t address)
+
+typedef struct {
+    osThreadFunc_t func;
+    void* argument;
+    const char* name;
+    ros_event_flags_t flags;
+} os2_thread_t;
+
+static os2_thread_t os2_threads[MAX_PROCESSES];
+
+static inline int os2_pid(osThreadId_t thread_id) {
+    process_t* proc = (process_t*)thread_id;
+    if (proc < process_table || proc >= process_table + MAX_PROCESSES || !proc->entry_point) return -1;
+    return (int)(proc - process_table);
+}
+
+static void os2_thread_entry(void) {
+    int pid = scheduler_current_pid();
+
+    // The lock orders this read after osThreadNew() has filled in the record
+    uint32_t irq = OS2_LOCK();
+    osThreadFunc_t func = os2_threads[pid].func;
+    void* argument = os2_threads[pid].argument;
+    OS2_UNLOCK(irq);
+
+    func(argument);
+    exit(0);
+}
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void* argument, const osThreadAttr_t* attr) {
+    if (OS2_IN_ISR() || !func) return NULL;
+    if (attr && attr->stack_size > sizeof(process_stacks[0])) return NULL;
+
+    osPriority_t priority = attr && attr->priority != osPriorityNone ? attr->priority : osPriorityNormal;
+    if (priority < osPriorityIdle || priority > osPriorityISR) return NULL;
+
+    uint32_t irq = OS2_LOCK();
+    int pid = create_process(os2_thread_entry, (uint8_t)priority);
+    if (pid >= 0) {
+        os2_threads[pid].func = func;
+        os2_threads[pid].argument = argument;
+        os2_threads[pid].name = attr ? attr->name : NULL;
+        ros_event_flags_init(&os2_threads[pid].flags);
+    }
+    OS2_UNLOCK(irq);
+    return pid >= 0 ? &process_table[pid] : NULL;
+}
+
+const char* osThreadGetName(osThreadId_t thread_id) {
+    int pid = os2_pid(thread_id);
+    return pid >= 0 ? os2_threads[pid].name : NULL;
+}
+
+osThreadId_t osThreadGetId(void) {
+    int pid = scheduler_current_pid();
+    return pid >= 0 ? &process_table[pid] : NULL;
+}
+
+osThreadState_t osThreadGetState(osThreadId_t thread_id) {
+    int pid = os2_pid(thread_id);
+    if (pid < 0) return osThreadError;
+    switch (process_table[pid].state) {
+        case PROCESS_READY:      return osThreadReady;
+        case PROCESS_RUNNING:    return osThreadRunning;
+        case PROCESS_WAITING:    return osThreadBlocked;
+        case PROCESS_TERMINATED: return osThreadTerminated;
+    }
+    return osThreadError;
+}
+
+osStatus_t osThreadSetPriority(osThreadId_t thread_id, osPriority_t priority) {
+    int pid = os2_pid(thread_id);
+    if (pid < 0 || priority < osPriorityIdle || priority > osPriorityISR) return osErrorParameter;
+    process_table[pid].priority = (uint8_t)priority;
+    return osOK;
+}
+
+osPriority_t osThreadGetPriority(osThreadId_t thread_id) {
+    int pid = os2_pid(thread_id);
+    return pid >= 0 ? (osPriority_t)process_table[pid].priority : osPriorityError;
+}
+
+osStatus_t osThreadYield(void) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    schedule();
+    return osOK;
+}
+
+osStatus_t osThreadSuspend(osThreadId_t thread_id) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    int pid = os2_pid(thread_id);
+    if (pid < 0 || process_table[pid].state == PROCESS_TERMINATED) return osErrorParameter;
+
+    if (pid == scheduler_current_pid()) {
+        process_block();
+    } else {
+        process_table[pid].wake_us = 0;
+        process_table[pid].state = PROCESS_WAITING;
+    }
+    return osOK;
+}
+
+osStatus_t osThreadResume(osThreadId_t thread_id) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    int pid = os2_pid(thread_id);
+    if (pid < 0 || process_table[pid].state != PROCESS_WAITING) return osErrorResource;
+    process_unblock(pid);
+    return osOK;
+}
+
+osStatus_t osThreadJoin(osThreadId_t thread_id) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    int pid = os2_pid(thread_id);
+    if (pid < 0 || pid == scheduler_current_pid()) return osErrorParameter;
+    wait(pid);
+    return osOK;
+}
+
+void osThreadExit(void) {
+    exit(0);
+
+    // exit() only returns outside a thread, where there is nothing to return to
+    __builtin_trap();
+}
+
+osStatus_t osThreadTerminate(osThreadId_t thread_id) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    int pid = os2_pid(thread_id);
+    if (pid < 0 || process_table[pid].state == PROCESS_TERMINATED) return osErrorResource;
+    if (pid == scheduler_current_pid()) osThreadExit();
+    process_terminate(pid, 0);
+    return osOK;
+}
+
+uint32_t osThreadGetCount(void) {
+    uint32_t count = 0;
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        if (process_table[i].entry_point && process_table[i].state != PROCESS_TERMINATED) count++;
+    }
+    return count;
+}
+
+uint32_t osThreadEnumerate(osThreadId_t* thread_array, uint32_t array_items) {
+    uint32_t count = 0;
+    for (int i = 0; i < MAX_PROCESSES && count < array_items; i++) {
+        if (process_table[i].entry_point && process_table[i].state != PROCESS_TERMINATED)
+            thread_array[count++] = &process_table[i];
+    }
+    return count;
+}
+
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags) {
+    int pid = os2_pid(thread_id);
+    if (pid < 0 || (flags & osFlagsError)) return osFlagsErrorParameter;
+    return ros_event_flags_set(&os2_threads[pid].flags, flags);
+}
+
+uint32_t osThreadFlagsClear(uint32_t flags) {
+    if (OS2_IN_ISR()) return osFlagsErrorISR;
+    int pid = scheduler_current_pid();
+    if (pid < 0 || (flags & osFlagsError)) return osFlagsErrorParameter;
+    return ros_event_flags_clear(&os2_threads[pid].flags, flags);
+}
+
+uint32_t osThreadFlagsGet(void) {
+    int pid = scheduler_current_pid();
+    if (OS2_IN_ISR() || pid < 0) return 0;
+    return ros_event_flags_get(&os2_threads[pid].flags);
+}
+
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout) {
+    if (OS2_IN_ISR()) return osFlagsErrorISR;
+    int pid = scheduler_current_pid();
+    if (pid < 0 || (flags & osFlagsError)) return osFlagsErrorParameter;
+
+    uint32_t observed;
+    if (!ros_event_flags_wait(&os2_threads[pid].flags, flags, options, os2_timeout_us(timeout), &observed))
+        return os2_flags_wait_failed(timeout);
+    return observed;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Delay
+
+osStatus_t osDelay(uint32_t ticks) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    if (ticks == 0) return osErrorParameter;
+
+    uint64_t deadline = timebase_now_us() + os2_timeout_us(ticks);
+    if (scheduler_current_pid() < 0) {
+        sleep_until(from_us_since_boot(deadline));
+        return osOK;
+    }
+    // process_unblock() also ends a sleep early, so sleep again until the deadline has passed
+    do {
+        process_sleep_until(deadline);
+    } while (timebase_now_us() < deadline);
+    return osOK;
+}
+
+osStatus_t osDelayUntil(uint32_t ticks) {
+    if (OS2_IN_ISR()) return osErrorISR;
+
+    uint32_t delta = ticks - osKernelGetTickCount();
+    if (delta == 0 || delta > 0x7FFFFFFFu) return osErrorParameter;
+    return osDelay(delta);
+}
+
+// ─────────────────────────────────────────────────────────────
+// Event flags
+
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t* attr) {
+    if (OS2_IN_ISR()) return NULL;
+    ros_event_flags_t* ef = OS2_ALLOC(os2_event_flags, attr);
+    if (ef) ros_event_flags_init(ef);
+    return ef;
+}
+
+const char* osEventFlagsGetName(osEventFlagsId_t ef_id) {
+    (void)ef_id;
+    return NULL;
+}
+
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags) {
+    if (!ef_id || (flags & osFlagsError)) return osFlagsErrorParameter;
+    return ros_event_flags_set((ros_event_flags_t*)ef_id, flags);
+}
+
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags) {
+    if (!ef_id || (flags & osFlagsError)) return osFlagsErrorParameter;
+    return ros_event_flags_clear((ros_event_flags_t*)ef_id, flags);
+}
+
+uint32_t osEventFlagsGet(osEventFlagsId_t ef_id) {
+    return ef_id ? ros_event_flags_get((ros_event_flags_t*)ef_id) : 0;
+}
+
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t timeout) {
+    if (!ef_id || (flags & osFlagsError)) return osFlagsErrorParameter;
+    if (OS2_IN_ISR() && timeout != 0) return osFlagsErrorParameter;
+
+    uint32_t observed;
+    if (!ros_event_flags_wait((ros_event_flags_t*)ef_id, flags, options, os2_timeout_us(timeout), &observed))
+        return os2_flags_wait_failed(timeout);
+    return observed;
+}
+
+osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    if (!ef_id) return osErrorParameter;
+    OS2_FREE(os2_event_flags, ef_id);
+    return osOK;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Mutex
+
+osMutexId_t osMutexNew(const osMutexAttr_t* attr) {
+    if (OS2_IN_ISR()) return NULL;
+    ros_mutex_t* mutex = OS2_ALLOC(os2_mutexes, attr);
+    if (mutex) ros_mutex_init(mutex, attr && (attr->attr_bits & osMutexRecursive));
+    return mutex;
+}
+
+const char* osMutexGetName(osMutexId_t mutex_id) {
+    (void)mutex_id;
+    return NULL;
+}
+
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    if (!mutex_id) return osErrorParameter;
+    return ros_mutex_lock((ros_mutex_t*)mutex_id, os2_timeout_us(timeout)) ? osOK : os2_wait_failed(timeout);
+}
+
+osStatus_t osMutexRelease(osMutexId_t mutex_id) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    if (!mutex_id) return osErrorParameter;
+    return ros_mutex_unlock((ros_mutex_t*)mutex_id) ? osOK : osErrorResource;
+}
+
+osThreadId_t osMutexGetOwner(osMutexId_t mutex_id) {
+    if (OS2_IN_ISR() || !mutex_id) return NULL;
+    int owner = ((ros_mutex_t*)mutex_id)->owner;
+    return owner >= 0 && owner < MAX_PROCESSES ? &process_table[owner] : NULL;
+}
+
+osStatus_t osMutexDelete(osMutexId_t mutex_id) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    if (!mutex_id) return osErrorParameter;
+    OS2_FREE(os2_mutexes, mutex_id);
+    return osOK;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Semaphore
+
+osSemaphoreId_t osSemaphoreNew(uint32_t max_count, uint32_t initial_count, const osSemaphoreAttr_t* attr) {
+    if (OS2_IN_ISR() || max_count == 0 || initial_count > max_count) return NULL;
+    ros_sem_t* sem = OS2_ALLOC(os2_semaphores, attr);
+    if (sem) ros_sem_init(sem, initial_count, max_count);
+    return sem;
+}
+
+const char* osSemaphoreGetName(osSemaphoreId_t semaphore_id) {
+    (void)semaphore_id;
+    return NULL;
+}
+
+osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout) {
+    if (!semaphore_id || (OS2_IN_ISR() && timeout != 0)) return osErrorParameter;
+    return ros_sem_acquire((ros_sem_t*)semaphore_id, os2_timeout_us(timeout)) ? osOK : os2_wait_failed(timeout);
+}
+
+osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id) {
+    if (!semaphore_id) return osErrorParameter;
+    return ros_sem_release((ros_sem_t*)semaphore_id) ? osOK : osErrorResource;
+}
+
+uint32_t osSemaphoreGetCount(osSemaphoreId_t semaphore_id) {
+    return semaphore_id ? ros_sem_count((ros_sem_t*)semaphore_id) : 0;
+}
+
+osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    if (!semaphore_id) return osErrorParameter;
+    OS2_FREE(os2_semaphores, semaphore_id);
+    return osOK;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Memory pool
+
+osMemoryPoolId_t osMemoryPoolNew(uint32_t block_count, uint32_t block_size, const osMemoryPoolAttr_t* attr) {
+    if (OS2_IN_ISR() || block_count == 0 || block_size == 0) return NULL;
+
+    uint32_t bytes = ROS_POOL_BYTES(block_count, block_size);
+    void* mem;
+    if (attr && attr->mp_mem) {
+        if (attr->mp_size < bytes || ((uintptr_t)attr->mp_mem & 3u)) return NULL;
+        mem = attr->mp_mem;
+    } else {
+        mem = os2_arena_alloc(bytes);
+    }
+    if (!mem) return NULL;
+
+    ros_pool_t* pool = OS2_ALLOC(os2_pools, attr);
+    if (pool) ros_pool_init(pool, mem, block_count, block_size);
+    return pool;
+}
+
+const char* osMemoryPoolGetName(osMemoryPoolId_t mp_id) {
+    (void)mp_id;
+    return NULL;
+}
+
+void* osMemoryPoolAlloc(osMemoryPoolId_t mp_id, uint32_t timeout) {
+    if (!mp_id || (OS2_IN_ISR() && timeout != 0)) return NULL;
+    return ros_pool_alloc((ros_pool_t*)mp_id, os2_timeout_us(timeout));
+}
+
+osStatus_t osMemoryPoolFree(osMemoryPoolId_t mp_id, void* block) {
+    if (!mp_id || !block) return osErrorParameter;
+    return ros_pool_free((ros_pool_t*)mp_id, block) ? osOK : osErrorParameter;
+}
+
+uint32_t osMemoryPoolGetCapacity(osMemoryPoolId_t mp_id) {
+    return mp_id ? ((ros_pool_t*)mp_id)->capacity : 0;
+}
+
+uint32_t osMemoryPoolGetBlockSize(osMemoryPoolId_t mp_id) {
+    return mp_id ? ((ros_pool_t*)mp_id)->block_size : 0;
+}
+
+uint32_t osMemoryPoolGetCount(osMemoryPoolId_t mp_id) {
+    return mp_id ? ((ros_pool_t*)mp_id)->used : 0;
+}
+
+uint32_t osMemoryPoolGetSpace(osMemoryPoolId_t mp_id) {
+    return mp_id ? ((ros_pool_t*)mp_id)->capacity - ((ros_pool_t*)mp_id)->used : 0;
+}
+
+osStatus_t osMemoryPoolDelete(osMemoryPoolId_t mp_id) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    if (!mp_id) return osErrorParameter;
+    OS2_FREE(os2_pools, mp_id);
+    return osOK;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Message queue (priorities are accepted but messages stay FIFO)
+
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t* attr) {
+    if (OS2_IN_ISR() || msg_count == 0 || msg_size == 0) return NULL;
+
+    uint32_t bytes = msg_count * msg_size;
+    void* mem;
+    if (attr && attr->mq_mem) {
+        if (attr->mq_size < bytes) return NULL;
+        mem = attr->mq_mem;
+    } else {
+        mem = os2_arena_alloc(bytes);
+    }
+    if (!mem) return NULL;
+
+    ros_queue_t* q = OS2_ALLOC(os2_queues, attr);
+    if (q) ros_queue_init(q, mem, msg_count, msg_size);
+    return q;
+}
+
+const char* osMessageQueueGetName(osMessageQueueId_t mq_id) {
+    (void)mq_id;
+    return NULL;
+}
+
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void* msg_ptr, uint8_t msg_prio, uint32_t timeout) {
+    (void)msg_prio;
+    if (!mq_id || !msg_ptr || (OS2_IN_ISR() && timeout != 0)) return osErrorParameter;
+    return ros_queue_put((ros_queue_t*)mq_id, msg_ptr, os2_timeout_us(timeout)) ? osOK : os2_wait_failed(timeout);
+}
+
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void* msg_ptr, uint8_t* msg_prio, uint32_t timeout) {
+    if (!mq_id || !msg_ptr || (OS2_IN_ISR() && timeout != 0)) return osErrorParameter;
+    if (!ros_queue_get((ros_queue_t*)mq_id, msg_ptr, os2_timeout_us(timeout))) return os2_wait_failed(timeout);
+    if (msg_prio) *msg_prio = 0;
+    return osOK;
+}
+
+uint32_t osMessageQueueGetCapacity(osMessageQueueId_t mq_id) {
+    return mq_id ? ((ros_queue_t*)mq_id)->capacity : 0;
+}
+
+uint32_t osMessageQueueGetMsgSize(osMessageQueueId_t mq_id) {
+    return mq_id ? ((ros_queue_t*)mq_id)->msg_size : 0;
+}
+
+uint32_t osMessageQueueGetCount(osMessageQueueId_t mq_id) {
+    return mq_id ? ((ros_queue_t*)mq_id)->count : 0;
+}
+
+uint32_t osMessageQueueGetSpace(osMessageQueueId_t mq_id) {
+    return mq_id ? ((ros_queue_t*)mq_id)->capacity - ((ros_queue_t*)mq_id)->count : 0;
+}
+
+osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    if (!mq_id) return osErrorParameter;
+    ros_queue_reset((ros_queue_t*)mq_id);
+    return osOK;
+}
+
+osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id) {
+    if (OS2_IN_ISR()) return osErrorISR;
+    if (!mq_id) return osErrorParameter;
+    OS2_FREE(os2_queues, mq_id);
+    return osOK;
+}
@@ -0,0 +1,88 @@
+#include "ros_log.h"
+#include "scheduler.h"
+#include <stdio.h>
+
+ros_log_ring_t ros_log_rings[NUM_CORES];
+
+// Record sites with this address report dropped records
+#define ROS_LOG_DROPPED_SITE 0u
+
+// Copy the next record of a ring into words[]; returns its length in words, 0 if empty
+static uint32_t ros_log_pop(ros_log_ring_t* ring, uint32_t words[2 + ROS_LOG_MAX_ARGS]) {
+    const uint32_t mask = ROS_LOG_RING_WORDS - 1;
+    uint32_t tail = ring->tail;
+    if (tail == ring->head) return 0;
+    __dmb();
+
+    words[0] = ring->buf[tail & mask];
+    words[1] = ring->buf[(tail + 1) & mask];
+    uint32_t n = ((const ros_log_site_t*)words[0])->nargs;
+    for (uint32_t i = 0; i < n; i++) words[2 + i] = ring->buf[(tail + 2 + i) & mask];
+
+    ring->tail = tail + 2 + n;
+    return 2 + n;
+}
+
+// Read and clear the dropped counter of a ring
+static uint32_t ros_log_take_dropped(ros_log_ring_t* ring) {
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t dropped = ring->dropped;
+    ring->dropped = 0;
+    restore_interrupts(irq);
+    return dropped;
+}
+
+uint32_t ros_log_drain_text(void) {
+    uint32_t words[2 + ROS_LOG_MAX_ARGS];
+    uint32_t count = 0;
+
+    for (uint core = 0; core < NUM_CORES; core++) {
+        ros_log_ring_t* ring = &ros_log_rings[core];
+        while (ros_log_pop(ring, words)) {
+            const ros_log_site_t* site = (const ros_log_site_t*)words[0];
+            const uint32_t* a = &words[2];
+            printf("[%10lu c%u] ", (unsigned long)words[1], core);
+            // Unused trailing arguments are ignored by printf
+            printf(site->fmt, a[0], a[1], a[2], a[3], a[4], a[5]);
+            printf("\n");
+            count++;
+        }
+
+        uint32_t dropped = ros_log_take_dropped(ring);
+        if (dropped) printf("[log c%u] %lu records dropped\n", core, (unsigned long)dropped);
+    }
+    return count;
+}
+
+static void ros_log_send_frame(void (*write)(const uint8_t*, size_t), uint core, const uint32_t* words, uint32_t n) {
+    uint8_t header[4] = { ROS_LOG_FRAME_SYNC0, ROS_LOG_FRAME_SYNC1, (uint8_t)core, (uint8_t)n };
+    write(header, sizeof(header));
+    write((const uint8_t*)words, n * sizeof(uint32_t));  // Cortex-M0+ is little-endian
+}
+
+uint32_t ros_log_drain_binary(void (*write)(const uint8_t* data, size_t len)) {
+    uint32_t words[2 + ROS_LOG_MAX_ARGS];
+    uint32_t count = 0;
+
+    for (uint core = 0; core < NUM_CORES; core++) {
+        ros_log_ring_t* ring = &ros_log_rings[core];
+        uint32_t n;
+        while ((n = ros_log_pop(ring, words)) != 0) {
+            ros_log_send_frame(write, core, words, n);
+            count++;
+        }
+
+        uint32_t dropped = ros_log_take_dropped(ring);
+        if (dropped) {
+            uint32_t notice[3] = { ROS_LOG_DROPPED_SITE, timebase_now_us32(), dropped };
+            ros_log_send_frame(write, core, notice, 3);
+        }
+    }
+    return count;
+}
+
+void ros_log_task(void) {
+    // One drain per dispatch: schedule() calls the entry point again once the sleep ends
+    ros_log_drain_text();
+    process_sleep_until(timebase_now_us() + ROS_LOG_DRAIN_PERIOD_US);
+}
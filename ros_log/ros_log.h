@@ -0,0 +1,158 @@
+#pragma once
+/**
+ * @file ros_log.h
+ * @brief Deferred binary logging for hot paths.
+ *
+ * ROS_LOG() stores only a pointer to a static call-site descriptor, a
+ * timestamp and the raw 32-bit arguments in a per-core ring; no formatting
+ * happens at the call site and nothing blocks. A low-priority task formats
+ * the records later (ros_log_drain_text) or ships them raw to the host
+ * (ros_log_drain_binary), where tools/ros_log_decode.py rebuilds the
+ * messages from the ELF.
+ *
+ * Arguments are 32-bit: integers, characters and pointers. `%s` arguments
+ * must point to strings that live for the whole program (flash literals);
+ * floating point is not supported.
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "timebase.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Ring size per core in 32-bit words (power of two)
+#ifndef ROS_LOG_RING_WORDS
+#define ROS_LOG_RING_WORDS 1024u
+#endif
+
+/// Period of ros_log_task() between drains
+#ifndef ROS_LOG_DRAIN_PERIOD_US
+#define ROS_LOG_DRAIN_PERIOD_US 10000u
+#endif
+
+#define ROS_LOG_MAX_ARGS 6u
+#define ROS_LOG_FRAME_SYNC0 0xA5u   // Binary record frame: A5 5A core nwords words[LE]
+#define ROS_LOG_FRAME_SYNC1 0x5Au
+
+/**
+ * @struct ros_log_site_t
+ * @brief Static descriptor of one ROS_LOG() call site; its address is the record ID.
+ *
+ * fmt    – printf-style format string
+ * nargs  – number of 32-bit arguments recorded
+ */
+typedef struct {
+    const char* fmt;
+    uint32_t nargs;
+} ros_log_site_t;
+
+/**
+ * @struct ros_log_ring_t
+ * @brief Per-core record ring (single producer: the owning core; single consumer: the drain task).
+ *
+ * Record layout: site address, timestamp (µs, low 32 bits), nargs argument words.
+ */
+typedef struct {
+    uint32_t buf[ROS_LOG_RING_WORDS];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t dropped;
+} ros_log_ring_t;
+
+extern ros_log_ring_t ros_log_rings[NUM_CORES];
+
+// Append one record to the calling core's ring; drops it (and counts) when full.
+// Interrupts are masked only for the few stores, so IRQ handlers may log too.
+static inline __attribute__((always_inline)) void ros_log_emit(const ros_log_site_t* site, uint32_t n,
+                                                               uint32_t a0, uint32_t a1, uint32_t a2,
+                                                               uint32_t a3, uint32_t a4, uint32_t a5) {
+    const uint32_t mask = ROS_LOG_RING_WORDS - 1;
+    ros_log_ring_t* ring = &ros_log_rings[get_core_num()];
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t head = ring->head;
+
+    if (ROS_LOG_RING_WORDS - (head - ring->tail) >= 2 + n) {
+        uint32_t* b = ring->buf;
+        b[head & mask] = (uint32_t)site;
+        b[(head + 1) & mask] = timebase_now_us32();
+        if (n > 0) b[(head + 2) & mask] = a0;
+        if (n > 1) b[(head + 3) & mask] = a1;
+        if (n > 2) b[(head + 4) & mask] = a2;
+        if (n > 3) b[(head + 5) & mask] = a3;
+        if (n > 4) b[(head + 6) & mask] = a4;
+        if (n > 5) b[(head + 7) & mask] = a5;
+        __dmb();
+        ring->head = head + 2 + n;
+    } else {
+        ring->dropped++;
+    }
+    restore_interrupts(irq);
+}
+
+// ─────────────────────────────────────────────────────────────
+// Argument counting and dispatch (0 to ROS_LOG_MAX_ARGS arguments)
+#define ROS_LOG_ARG(x) ((uint32_t)(uintptr_t)(x))
+#define ROS_LOG_NARGS(...) ROS_LOG_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define ROS_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, n, ...) n
+#define ROS_LOG_CAT(a, b) ROS_LOG_CAT_(a, b)
+#define ROS_LOG_CAT_(a, b) a##b
+
+#define ROS_LOG_EMIT_0(s)                   ros_log_emit(s, 0, 0, 0, 0, 0, 0, 0)
+#define ROS_LOG_EMIT_1(s, a)                ros_log_emit(s, 1, ROS_LOG_ARG(a), 0, 0, 0, 0, 0)
+#define ROS_LOG_EMIT_2(s, a, b)             ros_log_emit(s, 2, ROS_LOG_ARG(a), ROS_LOG_ARG(b), 0, 0, 0, 0)
+#define ROS_LOG_EMIT_3(s, a, b, c)          ros_log_emit(s, 3, ROS_LOG_ARG(a), ROS_LOG_ARG(b), ROS_LOG_ARG(c), 0, 0, 0)
+#define ROS_LOG_EMIT_4(s, a, b, c, d)       ros_log_emit(s, 4, ROS_LOG_ARG(a), ROS_LOG_ARG(b), ROS_LOG_ARG(c), \
+                                                         ROS_LOG_ARG(d), 0, 0)
+#define ROS_LOG_EMIT_5(s, a, b, c, d, e)    ros_log_emit(s, 5, ROS_LOG_ARG(a), ROS_LOG_ARG(b), ROS_LOG_ARG(c), \
+                                                         ROS_LOG_ARG(d), ROS_LOG_ARG(e), 0)
+#define ROS_LOG_EMIT_6(s, a, b, c, d, e, f) ros_log_emit(s, 6, ROS_LOG_ARG(a), ROS_LOG_ARG(b), ROS_LOG_ARG(c), \
+                                                         ROS_LOG_ARG(d), ROS_LOG_ARG(e), ROS_LOG_ARG(f))
+
+/**
+ * @brief Record a log message for deferred formatting.
+ *
+ * The format string and argument count go into a static descriptor in the
+ * `.ros_log_sites` section; only its address and the arguments are stored.
+ *
+ * @param fmt String literal printf format.
+ * @param ... Up to ROS_LOG_MAX_ARGS integer or pointer arguments.
+ */
+#define ROS_LOG(fmt, ...)                                                                          \
+    do {                                                                                           \
+        static const ros_log_site_t __attribute__((section(".ros_log_sites"), used, aligned(4)))  \
+            ros_log_site_ = { fmt, ROS_LOG_NARGS(__VA_ARGS__) };                                   \
+        ROS_LOG_CAT(ROS_LOG_EMIT_, ROS_LOG_NARGS(__VA_ARGS__))(&ros_log_site_, ##__VA_ARGS__);     \
+    } while (0)
+
+/**
+ * @brief Format and print all pending records of both cores with printf.
+ * @return Number of records drained.
+ */
+uint32_t ros_log_drain_text(void);
+
+/**
+ * @brief Send all pending records of both cores as binary frames.
+ *
+ * Frame: 0xA5 0x5A, core, word count, then the record words little-endian.
+ * A dropped-record notice is sent as a record with site address 0 and the
+ * number of lost records as its only argument.
+ *
+ * @param write Function that transmits a byte buffer.
+ * @return Number of records drained.
+ */
+uint32_t ros_log_drain_binary(void (*write)(const uint8_t* data, size_t len));
+
+/**
+ * @brief Drain task: formats pending records every ROS_LOG_DRAIN_PERIOD_US.
+ *
+ * Each dispatch drains once, sleeps for the period and returns.
+ * Register as a low-priority process, e.g. create_process(ros_log_task, 0).
+ */
+void ros_log_task(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,41 @@
+#include "scheduler_port.h"
+#include <ucontext.h>
+
+// Host port for the host builds of the bench and the conformance checks: one
+// ucontext per process on its process_stacks[] row, plus the idle context of
+// the thread that runs the dispatcher loop. The switch is immediate, also from
+// the emulated tick and interrupt, so the exception number the host shims
+// report is saved with each context: a process resumed from the tick runs in
+// thread mode, as it would after PendSV on target.
+
+static ucontext_t host_contexts[MAX_PROCESSES + 1];   // [0] is the idle context
+static uint host_exceptions[MAX_PROCESSES + 1];
+
+static inline ucontext_t* host_context(int pid) {
+    return &host_contexts[pid + 1];
+}
+
+void scheduler_port_init(void) {
+}
+
+void scheduler_port_switch(void) {
+    int from = scheduler_current_pid();
+    int to = scheduler_switch();
+    if (to == from) return;
+
+    if (to >= 0 && !process_table[to].sp) {
+        ucontext_t* c = host_context(to);
+        getcontext(c);
+        c->uc_stack.ss_sp = process_stacks[to];
+        c->uc_stack.ss_size = sizeof(process_stacks[to]);
+        c->uc_link = NULL;
+        makecontext(c, process_trampoline, 0);
+        // Only marks the context as built; the saved registers live in host_contexts
+        process_table[to].sp = &process_stacks[to][PROCESS_STACK_WORDS];
+        host_exceptions[to + 1] = 0;
+    }
+
+    host_exceptions[from + 1] = host_exception_number;
+    swapcontext(host_context(from), host_context(to));
+    host_exception_number = host_exceptions[from + 1];
+}
@@ -0,0 +1,27 @@
+#pragma once
+/**
+ * @file ros_hot.h
+ * @brief Placement of kernel hot paths in SRAM.
+ *
+ * With ROS_HOT_PATHS_IN_RAM=1 every function defined through ROS_HOT() goes
+ * to a `.time_critical.ros.<name>` section. The SDK linker scripts collect
+ * `.time_critical*` into `.data`, so startup copies these functions to the
+ * striped main SRAM and they run without touching XIP flash: an XIP cache miss
+ * during a context switch no longer adds jitter. With the option off (the
+ * default) ROS_HOT() is just the function name and the code stays in flash.
+ *
+ * Only the scheduler pick, context switch, block/unblock, sync object signal
+ * paths, the SVC and SysTick entries and the work queue post use it; each
+ * costs its size in SRAM. static inline helpers are inlined into them.
+ */
+
+#ifndef ROS_HOT_PATHS_IN_RAM
+#define ROS_HOT_PATHS_IN_RAM 0
+#endif
+
+/// @brief Define `func` in SRAM when ROS_HOT_PATHS_IN_RAM is set: `void ROS_HOT(schedule)(void) { ... }`
+#if ROS_HOT_PATHS_IN_RAM
+#define ROS_HOT(func) __attribute__((section(".time_critical.ros." #func))) func
+#else
+#define ROS_HOT(func) func
+#endif
@@ -0,0 +1,305 @@
+#include "ros_sync.h"
+#include "ros_hot.h"
+#include "xip_profile.h"
+#include "timebase.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+// One lock for all objects: critical sections are a few loads and stores
+#define SYNC_LOCK() spin_lock_blocking(spin_lock_instance(PICO_SPINLOCK_ID_OS2))
+#define SYNC_UNLOCK(irq) spin_unlock(spin_lock_instance(PICO_SPINLOCK_ID_OS2), irq)
+
+// Mutex owner ID used outside process context (before the first dispatch)
+#define SYNC_NO_PROCESS MAX_PROCESSES
+
+static inline int sync_self(void) {
+    int pid = scheduler_current_pid();
+    return pid < 0 ? SYNC_NO_PROCESS : pid;
+}
+
+static inline bool sync_can_block(void) {
+    return scheduler_current_pid() >= 0 && __get_current_exception() == 0;
+}
+
+static inline uint64_t sync_deadline(uint64_t timeout_us) {
+    if (timeout_us == ROS_WAIT_FOREVER) return UINT64_MAX;
+    return timebase_now_us() + timeout_us;
+}
+
+// Called with the lock held after a failed attempt. Registers the caller as a
+// waiter and blocks, or gives up once the deadline has passed. Releases the lock.
+// The caller retries once woken.
+static bool ROS_HOT(sync_wait)(volatile uint32_t* waiters, uint64_t deadline, uint32_t irq) {
+    if (!sync_can_block() || (deadline != UINT64_MAX && timebase_now_us() >= deadline)) {
+        if (scheduler_current_pid() >= 0) *waiters &= ~(1u << scheduler_current_pid());
+        SYNC_UNLOCK(irq);
+        return false;
+    }
+    *waiters |= 1u << scheduler_current_pid();
+    SYNC_UNLOCK(irq);
+    process_block_until(deadline);
+    return true;
+}
+
+// Wake every PID in a waiter mask taken under the lock
+static void ROS_HOT(sync_wake)(uint32_t mask) {
+    while (mask) {
+        int pid = __builtin_ctz(mask);
+        mask &= mask - 1;
+        process_unblock(pid);
+    }
+}
+
+// ─────────────────────────────────────────────────────────────
+// Semaphore
+
+void ros_sem_init(ros_sem_t* sem, uint32_t initial, uint32_t max) {
+    sem->count = initial;
+    sem->max = max;
+    sem->waiters = 0;
+}
+
+bool ROS_HOT(ros_sem_acquire)(ros_sem_t* sem, uint64_t timeout_us) {
+    uint64_t deadline = sync_deadline(timeout_us);
+    for (;;) {
+        uint32_t irq = SYNC_LOCK();
+        if (sem->count > 0) {
+            sem->count--;
+            SYNC_UNLOCK(irq);
+            return true;
+        }
+        if (!sync_wait(&sem->waiters, deadline, irq)) return false;
+    }
+}
+
+bool ROS_HOT(ros_sem_release)(ros_sem_t* sem) {
+    xip_profile_mark_t xip = xip_profile_begin();
+    uint32_t irq = SYNC_LOCK();
+    if (sem->count >= sem->max) {
+        SYNC_UNLOCK(irq);
+        return false;
+    }
+    sem->count++;
+    uint32_t waiters = sem->waiters;
+    sem->waiters = 0;
+    SYNC_UNLOCK(irq);
+
+    sync_wake(waiters);
+    xip_profile_end(XIP_PROFILE_SIGNAL, xip);
+    return true;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Mutex
+
+void ros_mutex_init(ros_mutex_t* mutex, bool recursive) {
+    mutex->owner = -1;
+    mutex->depth = 0;
+    mutex->recursive = recursive;
+    mutex->waiters = 0;
+}
+
+bool ROS_HOT(ros_mutex_lock)(ros_mutex_t* mutex, uint64_t timeout_us) {
+    int self = sync_self();
+    uint64_t deadline = sync_deadline(timeout_us);
+    for (;;) {
+        uint32_t irq = SYNC_LOCK();
+        if (mutex->owner == -1) {
+            mutex->owner = self;
+            mutex->depth = 1;
+            SYNC_UNLOCK(irq);
+            return true;
+        }
+        if (mutex->owner == self) {
+            bool ok = mutex->recursive;
+            if (ok) mutex->depth++;
+            SYNC_UNLOCK(irq);
+            return ok;
+        }
+        if (!sync_wait(&mutex->waiters, deadline, irq)) return false;
+    }
+}
+
+bool ROS_HOT(ros_mutex_unlock)(ros_mutex_t* mutex) {
+    xip_profile_mark_t xip = xip_profile_begin();
+    uint32_t waiters = 0;
+    uint32_t irq = SYNC_LOCK();
+    if (mutex->owner != sync_self()) {
+        SYNC_UNLOCK(irq);
+        return false;
+    }
+    if (--mutex->depth == 0) {
+        mutex->owner = -1;
+        waiters = mutex->waiters;
+        mutex->waiters = 0;
+    }
+    SYNC_UNLOCK(irq);
+
+    sync_wake(waiters);
+    xip_profile_end(XIP_PROFILE_SIGNAL, xip);
+    return true;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Event flags
+
+void ros_event_flags_init(ros_event_flags_t* ef) {
+    ef->flags = 0;
+    ef->waiters = 0;
+}
+
+uint32_t ROS_HOT(ros_event_flags_set)(ros_event_flags_t* ef, uint32_t flags) {
+    xip_profile_mark_t xip = xip_profile_begin();
+    uint32_t irq = SYNC_LOCK();
+    uint32_t result = ef->flags |= flags;
+    uint32_t waiters = ef->waiters;
+    ef->waiters = 0;
+    SYNC_UNLOCK(irq);
+
+    sync_wake(waiters);
+    xip_profile_end(XIP_PROFILE_SIGNAL, xip);
+    return result;
+}
+
+uint32_t ros_event_flags_clear(ros_event_flags_t* ef, uint32_t flags) {
+    uint32_t irq = SYNC_LOCK();
+    uint32_t before = ef->flags;
+    ef->flags = before & ~flags;
+    SYNC_UNLOCK(irq);
+    return before;
+}
+
+bool ROS_HOT(ros_event_flags_wait)(ros_event_flags_t* ef, uint32_t flags, uint32_t options, uint64_t timeout_us,
+                          uint32_t* out) {
+    uint64_t deadline = sync_deadline(timeout_us);
+    for (;;) {
+        uint32_t irq = SYNC_LOCK();
+        uint32_t current = ef->flags;
+        bool ready = (options & ROS_FLAGS_WAIT_ALL) ? (current & flags) == flags : (current & flags) != 0;
+        if (ready) {
+            if (!(options & ROS_FLAGS_NO_CLEAR)) ef->flags = current & ~flags;
+            SYNC_UNLOCK(irq);
+            if (out) *out = current;
+            return true;
+        }
+        if (!sync_wait(&ef->waiters, deadline, irq)) {
+            if (out) *out = current;
+            return false;
+        }
+    }
+}
+
+// ─────────────────────────────────────────────────────────────
+// Message queue (messages are copied under the lock; keep them small)
+
+void ros_queue_init(ros_queue_t* q, void* buf, uint32_t capacity, uint32_t msg_size) {
+    q->buf = (uint8_t*)buf;
+    q->msg_size = msg_size;
+    q->capacity = capacity;
+    q->head = 0;
+    q->count = 0;
+    q->send_waiters = 0;
+    q->recv_waiters = 0;
+}
+
+bool ROS_HOT(ros_queue_put)(ros_queue_t* q, const void* msg, uint64_t timeout_us) {
+    uint64_t deadline = sync_deadline(timeout_us);
+    for (;;) {
+        uint32_t irq = SYNC_LOCK();
+        if (q->count < q->capacity) {
+            uint32_t slot = q->head + q->count;
+            if (slot >= q->capacity) slot -= q->capacity;
+            memcpy(&q->buf[slot * q->msg_size], msg, q->msg_size);
+            q->count++;
+            uint32_t waiters = q->recv_waiters;
+            q->recv_waiters = 0;
+            SYNC_UNLOCK(irq);
+
+            sync_wake(waiters);
+            return true;
+        }
+        if (!sync_wait(&q->send_waiters, deadline, irq)) return false;
+    }
+}
+
+bool ROS_HOT(ros_queue_get)(ros_queue_t* q, void* msg, uint64_t timeout_us) {
+    uint64_t deadline = sync_deadline(timeout_us);
+    for (;;) {
+        uint32_t irq = SYNC_LOCK();
+        if (q->count > 0) {
+            memcpy(msg, &q->buf[q->head * q->msg_size], q->msg_size);
+            if (++q->head == q->capacity) q->head = 0;
+            q->count--;
+            uint32_t waiters = q->send_waiters;
+            q->send_waiters = 0;
+            SYNC_UNLOCK(irq);
+
+            sync_wake(waiters);
+            return true;
+        }
+        if (!sync_wait(&q->recv_waiters, deadline, irq)) return false;
+    }
+}
+
+void ros_queue_reset(ros_queue_t* q) {
+    uint32_t irq = SYNC_LOCK();
+    q->head = 0;
+    q->count = 0;
+    uint32_t waiters = q->send_waiters;
+    q->send_waiters = 0;
+    SYNC_UNLOCK(irq);
+
+    sync_wake(waiters);
+}
+
+// ─────────────────────────────────────────────────────────────
+// Memory pool
+
+void ros_pool_init(ros_pool_t* pool, void* buf, uint32_t capacity, uint32_t block_size) {
+    pool->buf = (uint8_t*)buf;
+    pool->block_size = (block_size + 3u) & ~3u;
+    pool->capacity = capacity;
+    pool->used = 0;
+    pool->waiters = 0;
+    pool->free_list = NULL;
+
+    // Link the blocks so the lowest address is handed out first
+    for (uint32_t i = capacity; i > 0; i--) {
+        void** block = (void**)&pool->buf[(i - 1) * pool->block_size];
+        *block = pool->free_list;
+        pool->free_list = block;
+    }
+}
+
+void* ros_pool_alloc(ros_pool_t* pool, uint64_t timeout_us) {
+    uint64_t deadline = sync_deadline(timeout_us);
+    for (;;) {
+        uint32_t irq = SYNC_LOCK();
+        void** block = (void**)pool->free_list;
+        if (block) {
+            pool->free_list = *block;
+            pool->used++;
+            SYNC_UNLOCK(irq);
+            return block;
+        }
+        if (!sync_wait(&pool->waiters, deadline, irq)) return NULL;
+    }
+}
+
+bool ros_pool_free(ros_pool_t* pool, void* block) {
+    uint32_t offset = (uint32_t)((uint8_t*)block - pool->buf);
+    if ((uint8_t*)block < pool->buf || offset >= pool->capacity * pool->block_size ||
+        offset % pool->block_size != 0)
+        return false;
+
+    uint32_t irq = SYNC_LOCK();
+    *(void**)block = pool->free_list;
+    pool->free_list = block;
+    pool->used--;
+    uint32_t waiters = pool->waiters;
+    pool->waiters = 0;
+    SYNC_UNLOCK(irq);
+
+    sync_wake(waiters);
+    return true;
+}
@@ -0,0 +1,158 @@
+#pragma once
+/**
+ * @file ros_sync.h
+ * @brief Native synchronization objects: semaphore, mutex, event flags,
+ *        message queue and fixed-block memory pool.
+ *
+ * Objects live in caller-provided storage; nothing is allocated. Each object
+ * keeps a 32-bit mask of the PIDs waiting on it. Waking is done with
+ * process_unblock(): a release wakes every waiter and each one retries,
+ * which is cheap with MAX_PROCESSES processes and keeps the objects small.
+ *
+ * Timeouts are relative, in microseconds: 0 tries once,
+ * ROS_WAIT_FOREVER blocks until the object is available. Calls from
+ * interrupt handlers, or before the scheduler has dispatched a process,
+ * never block and behave as if the timeout were 0. A waiting process is
+ * switched out, so any other process, an interrupt handler or the other core
+ * can end the wait.
+ */
+
+#include "pico/stdlib.h"
+#include "scheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Block until the object is available
+#define ROS_WAIT_FOREVER UINT64_MAX
+
+/// ros_event_flags_wait() options
+#define ROS_FLAGS_WAIT_ANY  0x0u   // Return when any requested flag is set
+#define ROS_FLAGS_WAIT_ALL  0x1u   // Return when all requested flags are set
+#define ROS_FLAGS_NO_CLEAR  0x2u   // Leave the flags set on return
+
+/// @brief Counting semaphore.
+typedef struct {
+    volatile uint32_t count;
+    uint32_t max;
+    volatile uint32_t waiters;
+} ros_sem_t;
+
+/// @brief Mutex owned by one process at a time, optionally recursive.
+typedef struct {
+    volatile int owner;         // Owning PID, -1 when free
+    uint32_t depth;             // Lock depth of the owner
+    bool recursive;
+    volatile uint32_t waiters;
+} ros_mutex_t;
+
+/// @brief 32 event flags.
+typedef struct {
+    volatile uint32_t flags;
+    volatile uint32_t waiters;
+} ros_event_flags_t;
+
+/// @brief Fixed-size message FIFO over a caller-provided buffer.
+typedef struct {
+    uint8_t* buf;               // capacity * msg_size bytes
+    uint32_t msg_size;
+    uint32_t capacity;
+    uint32_t head;              // Index of the oldest message
+    volatile uint32_t count;
+    volatile uint32_t send_waiters;
+    volatile uint32_t recv_waiters;
+} ros_queue_t;
+
+/// @brief Fixed-block memory pool over a caller-provided buffer.
+typedef struct {
+    uint8_t* buf;               // capacity * block_size bytes, 4-byte aligned
+    uint32_t block_size;        // Rounded up to a multiple of 4
+    uint32_t capacity;
+    void* free_list;            // Free blocks linked through their first word
+    volatile uint32_t used;
+    volatile uint32_t waiters;
+} ros_pool_t;
+
+// ─────────────────────────────────────────────────────────────
+// Semaphore
+
+void ros_sem_init(ros_sem_t* sem, uint32_t initial, uint32_t max);
+
+/// @return true if a token was taken, false on timeout.
+bool ros_sem_acquire(ros_sem_t* sem, uint64_t timeout_us);
+
+/// @return false if the count is already at its maximum.
+bool ros_sem_release(ros_sem_t* sem);
+
+static inline uint32_t ros_sem_count(const ros_sem_t* sem) {
+    return sem->count;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Mutex
+
+void ros_mutex_init(ros_mutex_t* mutex, bool recursive);
+
+/// @return true if the mutex is now held by the caller, false on timeout or
+///         when a non-recursive mutex is locked again by its owner.
+bool ros_mutex_lock(ros_mutex_t* mutex, uint64_t timeout_us);
+
+/// @return false if the caller does not own the mutex.
+bool ros_mutex_unlock(ros_mutex_t* mutex);
+
+// ─────────────────────────────────────────────────────────────
+// Event flags
+
+void ros_event_flags_init(ros_event_flags_t* ef);
+
+/// @return Flags after setting.
+uint32_t ros_event_flags_set(ros_event_flags_t* ef, uint32_t flags);
+
+/// @return Flags before clearing.
+uint32_t ros_event_flags_clear(ros_event_flags_t* ef, uint32_t flags);
+
+static inline uint32_t ros_event_flags_get(const ros_event_flags_t* ef) {
+    return ef->flags;
+}
+
+/**
+ * @brief Wait for any or all of `flags`.
+ * @param options ROS_FLAGS_WAIT_ANY or ROS_FLAGS_WAIT_ALL, optionally | ROS_FLAGS_NO_CLEAR.
+ * @param out Flags observed when the wait was satisfied (before clearing).
+ * @return true if satisfied, false on timeout.
+ */
+bool ros_event_flags_wait(ros_event_flags_t* ef, uint32_t flags, uint32_t options, uint64_t timeout_us,
+                          uint32_t* out);
+
+// ─────────────────────────────────────────────────────────────
+// Message queue
+
+void ros_queue_init(ros_queue_t* q, void* buf, uint32_t capacity, uint32_t msg_size);
+
+/// @return true if the message was copied in, false on timeout.
+bool ros_queue_put(ros_queue_t* q, const void* msg, uint64_t timeout_us);
+
+/// @return true if a message was copied out, false on timeout.
+bool ros_queue_get(ros_queue_t* q, void* msg, uint64_t timeout_us);
+
+/// @brief Drop all queued messages.
+void ros_queue_reset(ros_queue_t* q);
+
+// ─────────────────────────────────────────────────────────────
+// Memory pool
+
+void ros_pool_init(ros_pool_t* pool, void* buf, uint32_t capacity, uint32_t block_size);
+
+/// @return Block, or NULL on timeout.
+void* ros_pool_alloc(ros_pool_t* pool, uint64_t timeout_us);
+
+/// @return false if the block does not belong to the pool.
+bool ros_pool_free(ros_pool_t* pool, void* block);
+
+/// @brief Bytes needed for a pool of `capacity` blocks of `block_size` bytes.
+#define ROS_POOL_BYTES(capacity, block_size) ((capacity) * (((block_size) + 3u) & ~3u))
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,86 +1,296 @@
 #include "scheduler.h"
+#include "scheduler_port.h"
+#include "stack_guard.h"
+#include "ros_hot.h"
+#include "xip_profile.h"
+#include "timebase.h"
+#include "hardware/sync.h"
 
-#define MAX_PROCESSES 8
+_Static_assert(MAX_PROCESSES <= 32, "wait lists hold one bit per PID");
+_Static_assert((sizeof(process_t) + PROCESS_STACK_WORDS * sizeof(uint32_t)) * MAX_PROCESSES <= ROS_TASK_RAM_BUDGET,
+               "process table and stacks exceed ROS_TASK_RAM_BUDGET");
+_Static_assert(PROCESS_STACK_WORDS % 2 == 0, "process stacks keep the 8-byte alignment of the array");
 
-process_t process_table[MAX_PROCESSES];
-int current_pid = -1;
+// ROS_STATIC_TASKS (static_tasks.h) replaces the table and defines the count;
+// without it the count stays an unresolved weak reference
+__attribute__((weak)) process_t process_table[MAX_PROCESSES];
+uint32_t process_stacks[MAX_PROCESSES][PROCESS_STACK_WORDS] __attribute__((aligned(8)));
+extern const int ros_static_task_count __attribute__((weak));
+static volatile int current_pid[NUM_CORES] = { -1, -1 };   // -1: the core's idle context
 int next_pid = 0;
+static int last_pid = -1;   // Most recently dispatched; equal priorities take turns after it
+static uint32_t exit_waiters;   // PIDs blocked in wait()
+static volatile uint32_t scheduler_lock_depth = 0;
+
+// Guards block/unblock hand-offs and the pick between cores and interrupt handlers
+#define SCHEDULER_LOCK() spin_lock_blocking(spin_lock_instance(PICO_SPINLOCK_ID_OS1))
+#define SCHEDULER_UNLOCK(irq) spin_unlock(spin_lock_instance(PICO_SPINLOCK_ID_OS1), irq)
 
 void init_scheduler() {
-    memset(process_table, 0, sizeof(process_table));
-    current_pid = -1;
-    next_pid = 0;
+    // A static table arrives ready in initialized data
+    int static_tasks = &ros_static_task_count ? ros_static_task_count : 0;
+    if (static_tasks == 0)
+        memset(process_table, 0, sizeof(process_table));
+    for (uint core = 0; core < NUM_CORES; core++) current_pid[core] = -1;
+    next_pid = static_tasks;
+    last_pid = -1;
+    exit_waiters = 0;
+    scheduler_lock_depth = 0;
+    scheduler_core_init();
 }
 
-void create_init_process(void (*func)(void)) {
+void scheduler_core_init() {
+    stack_guard_init();
+    scheduler_port_init();
+}
+
+int create_process(void (*func)(void), uint8_t priority) {
+    if (next_pid >= MAX_PROCESSES)
+        return -1;
+
     process_t* proc = &process_table[next_pid];
     proc->pid = next_pid;
     proc->entry_point = func;
-    proc->priority = 1;
+    proc->priority = priority;
     proc->state = PROCESS_READY;
-    proc->sp = &proc->stack[255]; // Simplified stack setup
-    next_pid++;
+    proc->sp = NULL;    // The port builds the first context at the first dispatch
+    return next_pid++;
 }
 
-int fork() {
-    if (current_pid == -1 || next_pid >= MAX_PROCESSES)
-        return -1;
+void create_init_process(void (*func)(void)) {
+    create_process(func, 1);
+}
 
-    process_t* parent = &process_table[current_pid];
-    process_t* child = &process_table[next_pid];
+int fork() {
+    int cur = scheduler_current_pid();
+    if (cur == -1) return -1;
 
-    memcpy(child->stack, parent->stack, sizeof(parent->stack));
+    process_t* parent = &process_table[cur];
+    if (parent->fork_child) {
+        parent->fork_child = false;
+        return 0;
+    }
+    if (next_pid >= MAX_PROCESSES) return -1;
 
+    // The child gets a fresh stack and starts the parent's entry point from the top
+    process_t* child = &process_table[next_pid];
     child->pid = next_pid;
     child->priority = parent->priority;
-    child->state = PROCESS_READY;
-    child->sp = child->stack + 256 - ((uint32_t)(parent->stack + 256) - (uint32_t)(parent->sp)) / sizeof(uint32_t);
+    child->sp = NULL;
     child->entry_point = parent->entry_point;
     child->parent_pid = parent->pid;
+    child->fork_child = true;
+    child->state = PROCESS_READY;
 
     return next_pid++;
 }
 
 int exec(void (*new_func)(void)) {
-    if (current_pid == -1) return -1;
+    int cur = scheduler_current_pid();
+    if (cur == -1) return -1;
 
-    process_t* proc = &process_table[current_pid];
-    proc->entry_point = new_func;
-    memset(proc->stack, 0, sizeof(proc->stack));
-    proc->sp = &proc->stack[255]; // Reset SP
+    // process_trampoline() calls it when the running entry point returns
+    process_table[cur].entry_point = new_func;
     return 0;
 }
 
+void process_terminate(int pid, int code) {
+    if (pid < 0 || pid >= MAX_PROCESSES) return;
+
+    uint32_t irq = SCHEDULER_LOCK();
+    process_table[pid].exit_code = code;
+    process_table[pid].wake_us = 0;
+    process_table[pid].state = PROCESS_TERMINATED;
+    uint32_t waiters = exit_waiters;
+    exit_waiters = 0;
+    SCHEDULER_UNLOCK(irq);
+
+    // Each waiter checks whether its own child is the one that ended
+    while (waiters) {
+        int waiter = __builtin_ctz(waiters);
+        waiters &= waiters - 1;
+        process_unblock(waiter);
+    }
+}
+
 void exit(int code) {
-    if (current_pid == -1) return;
-    process_table[current_pid].state = PROCESS_TERMINATED;
-    process_table[current_pid].exit_code = code;
-    schedule();
+    int cur = scheduler_current_pid();
+    if (cur == -1) return;
+    process_terminate(cur, code);
+    // A terminated process is never picked again, so the first switch away is the last
+    for (;;) schedule();
 }
 
 int wait(int pid) {
+    if (pid < 0 || pid >= MAX_PROCESSES) return -1;
     for (;;) {
-        if (process_table[pid].state == PROCESS_TERMINATED)
-            return process_table[pid].exit_code;
+        int self = scheduler_current_pid();
+        uint32_t irq = SCHEDULER_LOCK();
+        if (process_table[pid].state == PROCESS_TERMINATED) {
+            int code = process_table[pid].exit_code;
+            SCHEDULER_UNLOCK(irq);
+            return code;
+        }
+        if (self >= 0) exit_waiters |= 1u << self;
+        SCHEDULER_UNLOCK(irq);
+
+        // The dispatcher loop cannot block; it runs whatever is ready until the child ends
+        if (self >= 0)
+            process_block();
+        else
+            schedule();
     }
 }
 
-void schedule() {
-    int next = -1;
+void process_sleep_until(uint64_t deadline_us) {
+    int cur = scheduler_current_pid();
+    if (cur == -1) return;
+
+    uint32_t irq = SCHEDULER_LOCK();
+    process_table[cur].wake_us = deadline_us;
+    process_table[cur].state = PROCESS_WAITING;
+    SCHEDULER_UNLOCK(irq);
+    schedule();
+}
+
+bool ROS_HOT(process_block_until)(uint64_t deadline_us) {
+    int cur = scheduler_current_pid();
+    if (cur == -1) return false;
+    process_t* proc = &process_table[cur];
+
+    uint32_t irq = SCHEDULER_LOCK();
+    if (proc->unblock_pending) {
+        proc->unblock_pending = false;
+        SCHEDULER_UNLOCK(irq);
+        return false;
+    }
+    proc->wake_us = deadline_us == UINT64_MAX ? 0 : deadline_us;
+    proc->state = PROCESS_WAITING;
+    SCHEDULER_UNLOCK(irq);
+    schedule();
+    return true;
+}
+
+bool process_block() {
+    return process_block_until(UINT64_MAX);
+}
+
+void ROS_HOT(process_unblock)(int pid) {
+    if (pid < 0 || pid >= MAX_PROCESSES) return;
+    process_t* proc = &process_table[pid];
+
+    xip_profile_mark_t xip = xip_profile_begin();
+    bool preempt = false;
+    uint32_t irq = SCHEDULER_LOCK();
+    if (proc->state == PROCESS_WAITING) {
+        proc->wake_us = 0;
+        proc->state = PROCESS_READY;
+        // The dispatcher loop picks it up on its own; a running process gives way to a higher priority
+        int cur = current_pid[get_core_num()];
+        preempt = cur >= 0 && proc->priority > process_table[cur].priority;
+    } else if (proc->state != PROCESS_TERMINATED) {
+        proc->unblock_pending = true;
+    }
+    SCHEDULER_UNLOCK(irq);
+    xip_profile_end(XIP_PROFILE_UNBLOCK, xip);
+    if (preempt) schedule();
+}
+
+uint32_t scheduler_lock() {
+    return scheduler_lock_depth++;
+}
+
+uint32_t scheduler_unlock() {
+    uint32_t depth = scheduler_lock_depth;
+    if (depth) scheduler_lock_depth = depth - 1;
+    return depth;
+}
+
+int scheduler_current_pid() {
+    return current_pid[get_core_num()];
+}
+
+uint64_t scheduler_next_deadline_us() {
+    uint64_t next = UINT64_MAX;
     for (int i = 0; i < MAX_PROCESSES; i++) {
-        if (process_table[i].state == PROCESS_READY) {
-            next = i;
-            break;
+        if (process_table[i].state == PROCESS_WAITING && process_table[i].wake_us &&
+            process_table[i].wake_us < next)
+            next = process_table[i].wake_us;
+    }
+    return next;
+}
+
+bool scheduler_has_ready() {
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        if (process_table[i].entry_point && process_table[i].state == PROCESS_READY && !process_table[i].dispatched)
+            return true;
+    }
+    return false;
+}
+
+// Move sleepers whose deadline has passed back to READY
+static void ROS_HOT(wake_sleepers)(void) {
+    uint64_t now = timebase_now_us();
+    uint32_t irq = SCHEDULER_LOCK();
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        if (process_table[i].state == PROCESS_WAITING && process_table[i].wake_us &&
+            process_table[i].wake_us <= now) {
+            process_table[i].wake_us = 0;
+            process_table[i].state = PROCESS_READY;
         }
     }
+    SCHEDULER_UNLOCK(irq);
+}
 
-    if (next != -1) {
-        current_pid = next;
+void ROS_HOT(schedule)() {
+    if (scheduler_lock_depth) return;
+    xip_profile_mark_t xip = xip_profile_begin();
+    wake_sleepers();
+    // The idle context only gives way; a process may be rotated out in favour of an equal priority
+    bool switch_needed = scheduler_current_pid() >= 0 || scheduler_has_ready();
+    xip_profile_end(XIP_PROFILE_SCHEDULE, xip);
+    if (switch_needed) scheduler_port_switch();
+}
+
+int ROS_HOT(scheduler_switch)(void) {
+    xip_profile_mark_t xip = xip_profile_begin();
+    uint core = get_core_num();
+    uint32_t irq = SCHEDULER_LOCK();
+    int from = current_pid[core];
+    if (from >= 0) {
+        // Its context is saved: it may be picked again here or on the other core
+        if (process_table[from].state == PROCESS_RUNNING) process_table[from].state = PROCESS_READY;
+        process_table[from].dispatched = false;
+    }
+
+    // Highest priority wins; among equals, start after the last dispatch so they take turns.
+    // Unused slots are zeroed, which reads as READY, so they are told apart by their entry point.
+    int next = -1;
+    for (int n = 1; n <= MAX_PROCESSES; n++) {
+        int i = (last_pid + n + MAX_PROCESSES) % MAX_PROCESSES;
+        if (process_table[i].entry_point && process_table[i].state == PROCESS_READY && !process_table[i].dispatched &&
+            (next == -1 || process_table[i].priority > process_table[next].priority))
+            next = i;
+    }
+    if (next >= 0) {
         process_table[next].state = PROCESS_RUNNING;
-        process_table[next].entry_point();
+        process_table[next].dispatched = true;
+        last_pid = next;
+    }
+    current_pid[core] = next;
+    SCHEDULER_UNLOCK(irq);
+
+    if (from != next) stack_guard_switch(from, next);
+    xip_profile_end(XIP_PROFILE_RESUME, xip);
+    return next;
+}
+
+void process_trampoline(void) {
+    for (;;) {
+        process_table[scheduler_current_pid()].entry_point();
     }
 }
 
-void SysTick_Handler() {
+void ROS_HOT(SysTick_Handler)() {
     schedule();
-}
\ No newline at end of file
+}
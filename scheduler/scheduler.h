@@ -1,6 +1,30 @@
 #pragma once
 #include "pico/stdlib.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Size of the process table (wait lists are 32-bit PID masks, so at most 32)
+#ifndef MAX_PROCESSES
+#define MAX_PROCESSES 8
+#endif
+
+/// Words in each process stack
+#ifndef PROCESS_STACK_WORDS
+#define PROCESS_STACK_WORDS 256
+#endif
+
+/// Upper bound in bytes for the process table and stacks together, checked at compile time
+#ifndef ROS_TASK_RAM_BUDGET
+#define ROS_TASK_RAM_BUDGET (64u * 1024u)
+#endif
+
+/// 1 to guard the process and core stacks with the MPU and canaries, 0 to leave them unchecked
+#ifndef ROS_STACK_GUARD
+#define ROS_STACK_GUARD 1
+#endif
+
 /// @brief Enum representing the possible states of a process
 typedef enum {
     PROCESS_READY,       // Process is ready to run
@@ -11,40 +35,138 @@ typedef enum {
 
 /// @brief Structure representing a process in the system
 typedef struct {
-    uint32_t* sp;               // Stack pointer for context switching
+    uint32_t* sp;               // Saved stack pointer while switched out (NULL until first dispatched)
     uint32_t pid;               // Unique process ID
     process_state_t state;      // Current state of the process
     uint8_t priority;           // Scheduling priority (higher is favored)
     void (*entry_point)(void);  // Function to execute when process runs
-    uint32_t stack[256];        // Process stack (adjust size as needed)
     int parent_pid;             // PID of the parent process (if forked)
     int exit_code;              // Exit status set by exit()
+    uint64_t wake_us;           // Timebase deadline while sleeping (0 = not sleeping)
+    volatile bool unblock_pending; // process_unblock() arrived while the process was not blocked
+    bool dispatched;            // Context is live on a core: running, or not yet saved by the switch away
+    bool fork_child;            // Forked and not yet past its first fork(), which returns 0
 } process_t;
 
+/// @brief Process table, indexed by PID (empty unless defined with ROS_STATIC_TASKS, see static_tasks.h)
+extern process_t process_table[MAX_PROCESSES];
+
+/// @brief Process stacks, indexed by PID; kept out of process_t so a static table stays small in .data
+///
+/// Each process runs on its own stack. Its first context is built at the top
+/// of the stack when it is first dispatched.
+extern uint32_t process_stacks[MAX_PROCESSES][PROCESS_STACK_WORDS];
+
 /// @brief Initialize internal data structures for the scheduler
+///
+/// Clears the process table, unless it was declared with ROS_STATIC_TASKS:
+/// that table is kept as built, so call this once before the first dispatch.
+/// Also runs scheduler_core_init() for the calling core.
 void init_scheduler(void);
 
+/// @brief Prepare the calling core to switch processes (context switch exception, stack guard)
+///
+/// init_scheduler() does this for core 0; core 1 calls it before its first
+/// schedule() (Kernel::launch_core1() does).
+void scheduler_core_init(void);
+
 /// @brief Clone current process to create a new one (similar to fork in Linux)
-/// @return PID of the new process, or -1 on failure
+///
+/// Without an MMU the parent's stack cannot be copied, so the child starts the
+/// parent's entry point from the top on its own stack; the first fork() it
+/// calls returns 0 instead of forking again.
+/// @return PID of the new process to the parent, 0 in the child, or -1 on failure
 int fork(void);
 
 /// @brief Replace current process’s code with new function (like exec in Linux)
+///
+/// The new function becomes the entry point and runs, from the top of the
+/// same stack, once the current entry point returns.
 /// @param new_func Pointer to new function to execute
 /// @return 0 on success, -1 on failure
 int exec(void (*new_func)(void));
 
 /// @brief Terminate current process and set its exit status
+///
+/// Does not return when called from a process; outside one it does nothing.
 /// @param code Exit status (visible to parent via wait)
 void exit(int code);
 
 /// @brief Wait for a process to terminate by PID
+///
+/// A process blocks until the other one exits. Outside a process (the
+/// dispatcher loop) this runs schedule() until it has.
 /// @param pid PID of the child process to wait on
-/// @return Exit code of terminated child
+/// @return Exit code of terminated child, or -1 for an invalid PID
 int wait(int pid);
 
-/// @brief Choose the next process to run and switch context
+/// @brief Terminate a process (exit() for the current one) and wake its wait() callers
+/// @param pid PID of the process to terminate
+/// @param code Exit status reported by wait()
+void process_terminate(int pid, int code);
+
+/// @brief Choose the next process to run on this core and switch to it
+///
+/// Each process runs on its own stack and keeps its place while switched out:
+/// a blocking call returns once the process is woken and dispatched again.
+/// The entry point is called again each time it returns, so a body may do one
+/// pass of work and return, or loop by itself. In a process this is a yield
+/// to equal or higher priorities; the dispatcher loop (no process current)
+/// only switches when something is ready. Interrupt handlers request the
+/// switch, which takes place when the last of them returns.
 void schedule(void);
 
+/// @brief Put the current process to sleep until an absolute timebase deadline
+/// @param deadline_us Wake-up time in timebase microseconds (see timebase_now_us)
+void process_sleep_until(uint64_t deadline_us);
+
+/// @brief Block the current process until another context calls process_unblock()
+///
+/// Returns immediately if an unblock arrived since the last process_block(), so a
+/// wake-up raised between checking for work and blocking is never lost.
+/// @return true once the process has blocked and been woken again;
+///         false if it consumed a pending unblock without blocking, so it
+///         should look for work again
+bool process_block(void);
+
+/// @brief Block the current process until process_unblock() or a timebase deadline
+/// @param deadline_us Wake-up time in timebase microseconds, or UINT64_MAX for no timeout
+/// @return As for process_block()
+bool process_block_until(uint64_t deadline_us);
+
+/// @brief Make a blocked process ready again (safe from interrupt handlers and the other core)
+///
+/// Also ends process_block_until() and process_sleep_until() waits early. A
+/// woken process of higher priority than the one running on this core
+/// preempts it; the other core picks it up on its next schedule().
+/// @param pid PID of the process to wake
+void process_unblock(int pid);
+
+/// @brief Stop schedule() from switching processes until the matching scheduler_unlock()
+/// @return Lock depth before the call
+uint32_t scheduler_lock(void);
+
+/// @brief Undo one scheduler_lock()
+/// @return Lock depth before the call
+uint32_t scheduler_unlock(void);
+
+/// @brief PID of the process running on the calling core, or -1 outside a process
+int scheduler_current_pid(void);
+
+/// @brief Earliest wake-up deadline among sleeping processes
+/// @return Deadline in timebase microseconds, or UINT64_MAX if nothing is sleeping
+uint64_t scheduler_next_deadline_us(void);
+
+/// @brief Query whether any process is ready to run
+/// @return true if at least one process is in PROCESS_READY and not live on a core
+bool scheduler_has_ready(void);
+
+/// @brief Create a process with a given priority
+/// @param func Function to assign as entry point of the process
+/// @param priority Scheduling priority (higher is favored; equal priorities take turns)
+/// @return PID of the new process, or -1 if the process table is full
+int create_process(void (*func)(void), uint8_t priority);
+
 /// @brief Manually create the first process to kickstart scheduler
 /// @param func Function to assign as entry point of initial process
 void create_init_process(void (*func)(void));
@@ -52,3 +174,6 @@ void create_init_process(void (*func)(void));
 /// @brief Interrupt service routine for SysTick timer (used for preemptive scheduling)
 void SysTick_Handler(void);
 
+#ifdef __cplusplus
+}
+#endif
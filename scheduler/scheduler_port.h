@@ -0,0 +1,32 @@
+#pragma once
+/**
+ * @file scheduler_port.h
+ * @brief Context switch interface between scheduler.c and its port.
+ *
+ * scheduler.c decides which process runs on each core; the port saves and
+ * restores the contexts. scheduler_port_rp2040.c switches in PendSV, with
+ * processes on their own stacks through PSP and each core's dispatcher loop
+ * (the idle context) on MSP. host/scheduler_port_host.c does the same with
+ * ucontext for the host builds.
+ */
+
+#include "scheduler.h"
+
+/// @brief Per-core setup: install and prioritise the switch exception.
+void scheduler_port_init(void);
+
+/// @brief Switch to the context scheduler_switch() picks. In thread mode the
+///        switch happens before this returns; from a handler, once the last
+///        handler returns.
+void scheduler_port_switch(void);
+
+/// @brief Hand the calling core's current context back and pick the next one.
+///
+/// Called by the port with the outgoing context already saved. Makes the
+/// pick current on this core and marks it dispatched.
+/// @return PID to run next on this core, or -1 for the core's idle context
+int scheduler_switch(void);
+
+/// @brief First frame of every process context: calls the entry point, again
+///        each time it returns, until the process exits.
+void process_trampoline(void) __attribute__((noreturn));
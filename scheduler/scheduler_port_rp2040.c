@@ -0,0 +1,105 @@
+#include "scheduler_port.h"
+#include "ros_hot.h"
+#include "hardware/exception.h"
+#include "hardware/irq.h"
+#include "hardware/structs/scb.h"
+
+// xPSR of a fresh context: Thumb state, no exception active
+#define PORT_INITIAL_XPSR 0x01000000u
+
+// Words of a saved context: r4-r7, r8-r11, then the hardware frame r0-r3, r12, lr, pc, xPSR
+#define PORT_FRAME_WORDS 16
+
+// Saved MSP of each core's idle context (the dispatcher loop), tagged with bit 0
+static uintptr_t idle_sp[NUM_CORES];
+
+// The context PendSV restores the first time the process is dispatched
+static uint32_t* port_initial_frame(int pid) {
+    uint32_t* sp = &process_stacks[pid][PROCESS_STACK_WORDS] - PORT_FRAME_WORDS;
+    for (int i = 0; i < PORT_FRAME_WORDS; i++) sp[i] = 0;
+    sp[14] = (uint32_t)process_trampoline & ~1u;   // pc: the frame holds it without the Thumb bit
+    sp[15] = PORT_INITIAL_XPSR;
+    return sp;
+}
+
+// Called from PendSV with the outgoing context saved at `sp` (bit 0 set for an
+// idle context on MSP); returns the incoming one in the same form
+uintptr_t __attribute__((used)) ROS_HOT(scheduler_port_pendsv)(uintptr_t sp) {
+    uint core = get_core_num();
+    int from = scheduler_current_pid();
+    if (from < 0)
+        idle_sp[core] = sp;
+    else
+        process_table[from].sp = (uint32_t*)sp;
+
+    int to = scheduler_switch();
+    if (to < 0) return idle_sp[core];
+    if (!process_table[to].sp) process_table[to].sp = port_initial_frame(to);
+    return (uintptr_t)process_table[to].sp;
+}
+
+// Save r4-r11 below the hardware frame of whichever stack was interrupted,
+// let the scheduler pick, then restore the pick and return to it. Processes
+// run on PSP; the idle context stays on MSP, so its saved registers stay on
+// MSP too and MSP is moved below them while it is switched out.
+static void __attribute__((naked)) ROS_HOT(scheduler_pendsv)(void) {
+    __asm volatile(
+        "movs r1, #4\n"
+        "mov r2, lr\n"
+        "tst r2, r1\n"
+        "bne 1f\n"
+        "mrs r0, msp\n"
+        "subs r0, #32\n"
+        "msr msp, r0\n"
+        "movs r1, #1\n"
+        "b 2f\n"
+        "1:\n"
+        "mrs r0, psp\n"
+        "subs r0, #32\n"
+        "movs r1, #0\n"
+        "2:\n"
+        "mov r3, r0\n"
+        "stmia r3!, {r4-r7}\n"
+        "mov r4, r8\n"
+        "mov r5, r9\n"
+        "mov r6, r10\n"
+        "mov r7, r11\n"
+        "stmia r3!, {r4-r7}\n"
+        "orrs r0, r1\n"
+        "bl scheduler_port_pendsv\n"
+        "movs r1, #1\n"
+        "ands r1, r0\n"
+        "bics r0, r1\n"
+        "mov r3, r0\n"
+        "adds r3, #16\n"
+        "ldmia r3!, {r4-r7}\n"
+        "mov r8, r4\n"
+        "mov r9, r5\n"
+        "mov r10, r6\n"
+        "mov r11, r7\n"
+        "ldmia r0!, {r4-r7}\n"
+        "adds r0, #16\n"
+        "cmp r1, #0\n"
+        "bne 3f\n"
+        "msr psp, r0\n"
+        "movs r0, #2\n"
+        "mvns r0, r0\n"          // 0xFFFFFFFD: thread mode, PSP
+        "bx r0\n"
+        "3:\n"
+        "msr msp, r0\n"
+        "movs r0, #6\n"
+        "mvns r0, r0\n"          // 0xFFFFFFF9: thread mode, MSP
+        "bx r0\n");
+}
+
+void scheduler_port_init(void) {
+    if (exception_get_vtable_handler(PENDSV_EXCEPTION) != scheduler_pendsv)
+        exception_set_exclusive_handler(PENDSV_EXCEPTION, scheduler_pendsv);
+    // Lowest priority, so PendSV only ever interrupts thread mode, which its exception return assumes
+    exception_set_priority(PENDSV_EXCEPTION, PICO_LOWEST_IRQ_PRIORITY);
+}
+
+void ROS_HOT(scheduler_port_switch)(void) {
+    scb_hw->icsr = M0PLUS_ICSR_PENDSVSET_BITS;
+    __asm volatile("dsb\n isb" ::: "memory");
+}
@@ -0,0 +1,135 @@
+#include "stack_guard.h"
+#include "ros_hot.h"
+
+#if ROS_STACK_GUARD
+
+#include "master_caution.h"
+#include "hardware/exception.h"
+#include "hardware/structs/mpu.h"
+
+// RASR for a 256-byte region (SIZE = 7) with no access and no execute; the
+// subregion-disable bits pick the one 32-byte subregion holding the band
+#define GUARD_RASR(srd) (M0PLUS_MPU_RASR_ENABLE_BITS | (7u << M0PLUS_MPU_RASR_SIZE_LSB) | \
+                         ((uint32_t)(srd) << M0PLUS_MPU_RASR_SRD_LSB) | M0PLUS_MPU_RASR_XN_BITS)
+
+// A fault whose exception frame lies this close to a band came from an overflow
+// of that stack; below the band too, since a large frame can step over it
+#define GUARD_FAULT_SLACK_WORDS 16
+
+// Core stack limits from the SDK linker script; core 1's is the one multicore_launch_core1() uses
+extern uint32_t __StackBottom[];
+extern uint32_t __StackOneBottom[];
+
+static exception_handler_t previous_hardfault;
+
+static inline uint32_t* band_above(const void* bottom) {
+    return (uint32_t*)(((uintptr_t)bottom + 31u) & ~(uintptr_t)31u);
+}
+
+// Lowest 32-byte aligned band inside the stack of `pid`, or this core's stack for -1
+static inline uint32_t* guard_band(int pid) {
+    if (pid >= 0) return band_above(process_stacks[pid]);
+    return band_above(get_core_num() ? __StackOneBottom : __StackBottom);
+}
+
+static void guard_on(uint32_t region, const uint32_t* band) {
+#if STACK_GUARD_USE_MPU
+    uint32_t addr = (uint32_t)band;
+    // Background map stays on for everything outside the enabled regions
+    mpu_hw->ctrl = M0PLUS_MPU_CTRL_PRIVDEFENA_BITS | M0PLUS_MPU_CTRL_ENABLE_BITS;
+    mpu_hw->rnr = region;
+    mpu_hw->rbar = (addr & ~0xFFu) | M0PLUS_MPU_RBAR_VALID_BITS | region;
+    mpu_hw->rasr = GUARD_RASR(0xFFu ^ (1u << ((addr >> 5) & 7u)));
+    __asm volatile("dsb\n isb" ::: "memory");
+#else
+    (void)region;
+    (void)band;
+#endif
+}
+
+static void guard_off(uint32_t region) {
+#if STACK_GUARD_USE_MPU
+    mpu_hw->rnr = region;
+    mpu_hw->rasr = 0;
+    __asm volatile("dsb\n isb" ::: "memory");
+#else
+    (void)region;
+#endif
+}
+
+static void paint(uint32_t* band) {
+    for (int i = 0; i < STACK_GUARD_WORDS; i++) band[i] = STACK_GUARD_CANARY;
+}
+
+bool ROS_HOT(stack_guard_intact)(int pid) {
+    const uint32_t* band = guard_band(pid);
+    for (int i = 0; i < STACK_GUARD_WORDS; i++) {
+        if (band[i] != STACK_GUARD_CANARY) return false;
+    }
+    return true;
+}
+
+static inline bool near_band(const uint32_t* frame, const uint32_t* band) {
+    return frame >= band - GUARD_FAULT_SLACK_WORDS && frame < band + STACK_GUARD_WORDS + GUARD_FAULT_SLACK_WORDS;
+}
+
+// Called from the HardFault trampoline with the stacked exception frame and
+// whether it was stacked on PSP, i.e. by the process running on this core
+void __attribute__((used)) stack_guard_fault(uint32_t* frame, uint32_t on_process_stack) {
+    int pid = on_process_stack ? scheduler_current_pid() : -1;
+    uint32_t* band = guard_band(pid);
+    guard_off(STACK_GUARD_MPU_REGION);
+    guard_off(STACK_GUARD_CORE_MPU_REGION);
+    if (near_band(frame, band))
+        master_caution_raise(CAUTION_STACK_OVERFLOW, pid, (uint32_t)frame);
+    if (!stack_guard_intact(pid))
+        master_caution_raise(CAUTION_STACK_CANARY, pid, (uint32_t)band);
+    previous_hardfault();
+}
+
+// Pass the frame of whichever stack the fault was taken on. A fault in a
+// process is stacked on its PSP, which leaves MSP intact for the report.
+static void __attribute__((naked)) stack_guard_hardfault(void) {
+    __asm volatile(
+        "movs r1, #4\n"
+        "mov r0, lr\n"
+        "ands r1, r0\n"
+        "mrs r0, msp\n"
+        "beq 1f\n"
+        "mrs r0, psp\n"
+        "1:\n"
+        "bl stack_guard_fault\n"
+        "b .\n");
+}
+
+void stack_guard_init(void) {
+    // The band is at the far end of a live stack, so painting it cannot clobber a frame
+    uint32_t* band = guard_band(-1);
+    guard_off(STACK_GUARD_CORE_MPU_REGION);
+    guard_off(STACK_GUARD_MPU_REGION);
+    paint(band);
+    guard_on(STACK_GUARD_CORE_MPU_REGION, band);
+
+    exception_handler_t current = exception_get_vtable_handler(HARDFAULT_EXCEPTION);
+    if (current != stack_guard_hardfault) {
+        previous_hardfault = current;
+        exception_set_exclusive_handler(HARDFAULT_EXCEPTION, stack_guard_hardfault);
+    }
+}
+
+void ROS_HOT(stack_guard_switch)(int from, int to) {
+    if (from >= 0 && !stack_guard_intact(from))
+        master_caution_raise(CAUTION_STACK_CANARY, from, (uint32_t)guard_band(from));
+    if (!stack_guard_intact(-1))
+        master_caution_raise(CAUTION_STACK_CANARY, -1, (uint32_t)guard_band(-1));
+
+    if (to < 0) {
+        guard_off(STACK_GUARD_MPU_REGION);
+        return;
+    }
+    // A context not built yet has a fresh stack, so its band is painted now
+    if (!process_table[to].sp) paint(guard_band(to));
+    guard_on(STACK_GUARD_MPU_REGION, guard_band(to));
+}
+
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+/**
+ * @file stack_guard.h
+ * @brief Stack overflow detection: MPU guard bands and canaries.
+ *
+ * Each process runs on its row of process_stacks[] through PSP; each core's
+ * dispatcher loop and the interrupt handlers run on the core stack through
+ * MSP. Both kinds of stack have a guard band at their lowest 32-byte aligned
+ * STACK_GUARD_WORDS, filled with STACK_GUARD_CANARY and covered by an MPU
+ * region on the core that uses it, so a write into the band faults before
+ * the memory below it (for a process, the top of the next lower PID's stack)
+ * is touched:
+ *
+ * - The core stack band (__StackBottom, __StackOneBottom) is painted and
+ *   covered by STACK_GUARD_CORE_MPU_REGION once per core, by
+ *   stack_guard_init().
+ * - A process band is painted when the process is first dispatched, and
+ *   STACK_GUARD_MPU_REGION is moved onto the band of whichever process each
+ *   switch brings in, so every core guards exactly the stack it runs on.
+ *
+ * Each switch also checks the canaries of the outgoing process and of the
+ * core stack, which catches overflows with STACK_GUARD_USE_MPU set to 0. That
+ * check runs in the switch, on MSP, so it reports even when the overflowing
+ * process can no longer run.
+ *
+ * Reports go through master_caution_raise() with the PID that owns the
+ * overflowing stack: the process current on the faulting core for a PSP
+ * fault or process band, -1 for a core stack. A fault in a process is stacked
+ * on its PSP; when the push that hit the band leaves no room for that frame
+ * either, the core locks up at the guard address instead, which a debugger
+ * shows, and the band still keeps the neighbouring stack intact.
+ */
+
+#include "scheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Guard band size: 8 words is one 32-byte MPU subregion, the smallest the M0+ can protect
+#define STACK_GUARD_WORDS 8
+
+/// Pattern painted over the guard band
+#define STACK_GUARD_CANARY 0x5AFEC0DEu
+
+/// MPU region that follows the running process's band (the SDK's PICO_USE_STACK_GUARDS uses region 0)
+#ifndef STACK_GUARD_MPU_REGION
+#define STACK_GUARD_MPU_REGION 7
+#endif
+
+/// MPU region for the core stack band
+#ifndef STACK_GUARD_CORE_MPU_REGION
+#define STACK_GUARD_CORE_MPU_REGION 6
+#endif
+
+/// 0 keeps only the canary check
+#ifndef STACK_GUARD_USE_MPU
+#define STACK_GUARD_USE_MPU 1
+#endif
+
+#if ROS_STACK_GUARD
+
+/**
+ * @brief Paint this core's stack band, point the MPU at it and hook HardFault.
+ *
+ * Each core has its own stack and MPU: init_scheduler() sets up core 0 and
+ * Kernel::launch_core1() core 1.
+ */
+void stack_guard_init(void);
+
+/**
+ * @brief Check the outgoing canaries and guard the incoming stack.
+ *
+ * Called by scheduler_switch() on the switching core when `to` differs from
+ * `from`; -1 is the core's idle context, which runs on the core stack.
+ */
+void stack_guard_switch(int from, int to);
+
+/// @return true if the band of process `pid`, or of this core's stack for -1, still holds the canary.
+bool stack_guard_intact(int pid);
+
+#else
+
+static inline void stack_guard_init(void) {}
+static inline void stack_guard_switch(int from, int to) { (void)from; (void)to; }
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,107 @@
+#pragma once
+/**
+ * @file static_tasks.h
+ * @brief Process table declared at build time.
+ *
+ * ROS_STATIC_TASKS() defines process_table with its PCBs filled in: PID,
+ * priority and entry point land in initialized data, so startup copies them
+ * with the rest of .data and no create_process() calls run before the first
+ * dispatch. Each task runs on its row of process_stacks[], zeroed .bss that
+ * costs no flash; the scheduler port builds the task's first context at the
+ * top of that row when the task is first dispatched, so the PCB carries no
+ * stack pointer.
+ * init_scheduler() keeps such a table instead of clearing it; later
+ * create_process() calls take the PIDs after the highest declared one.
+ *
+ * Use it once, at file scope in a C or C++ file:
+ *
+ *   ROS_STATIC_TASKS(
+ *       ROS_TASK(0, sensor_task, 2),
+ *       ROS_TASK(1, shell_task, 1)
+ *   );
+ *
+ * In C the PID picks the table slot, so PIDs may come in any order and
+ * leave gaps. C++ has no array designators: there the entries fill the
+ * slots in order, and a PID that differs from its position fails to
+ * compile.
+ *
+ * A PID at or above MAX_PROCESSES fails to compile, as does a table and
+ * stacks larger than ROS_TASK_RAM_BUDGET: the stacks are where the tasks
+ * run, so they count. Only the PCBs, MAX_PROCESSES * sizeof(process_t)
+ * bytes, are copied from flash as the .data load image.
+ */
+
+#include "scheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Slots filled in by ROS_STATIC_TASKS (highest PID + 1)
+extern const int ros_static_task_count;
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifndef __cplusplus
+
+#define ROS_STATIC_TASKS_BUDGET_ASSERT                                               \
+    _Static_assert((sizeof(process_t) + sizeof(process_stacks[0])) * MAX_PROCESSES <= ROS_TASK_RAM_BUDGET, \
+                   "process table and stacks exceed ROS_TASK_RAM_BUDGET")
+
+/// @brief One PCB initializer: `pid` is the table index, lower PIDs need not all be used.
+#define ROS_TASK(pid_, entry_, priority_)                                           \
+    [pid_] = {                                                                      \
+        .pid = (pid_),                                                              \
+        .state = PROCESS_READY,                                                     \
+        .priority = (priority_),                                                    \
+        .entry_point = (entry_),                                                    \
+    }
+
+/// @brief Define process_table from ROS_TASK() entries (replaces the scheduler's empty table).
+#define ROS_STATIC_TASKS(...)                                                       \
+    ROS_STATIC_TASKS_BUDGET_ASSERT;                                                 \
+    process_t process_table[MAX_PROCESSES] = { __VA_ARGS__ };                       \
+    const int ros_static_task_count = sizeof((process_t[]){ __VA_ARGS__ }) / sizeof(process_t)
+
+#else
+
+#define ROS_STATIC_TASKS_BUDGET_ASSERT                                               \
+    static_assert((sizeof(process_t) + sizeof(process_stacks[0])) * MAX_PROCESSES <= ROS_TASK_RAM_BUDGET, \
+                  "process table and stacks exceed ROS_TASK_RAM_BUDGET")
+
+/// Leading PCB fields as a literal type, so the entries can be checked at compile time
+struct ros_static_task_t {
+    uint32_t* sp;
+    uint32_t pid;
+    process_state_t state;
+    uint8_t priority;
+    void (*entry_point)(void);
+};
+
+template <size_t N>
+constexpr bool ros_static_tasks_in_order(const ros_static_task_t (&tasks)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        if (tasks[i].pid != i) return false;
+    }
+    return N <= MAX_PROCESSES;
+}
+
+/// @brief One PCB initializer: positional in C++, so `pid` must equal the entry's position.
+#define ROS_TASK(pid_, entry_, priority_) \
+    { nullptr, (uint32_t)(pid_), PROCESS_READY, (uint8_t)(priority_), (entry_) }
+
+/// @brief Define process_table from ROS_TASK() entries (replaces the scheduler's empty table).
+#define ROS_STATIC_TASKS(...)                                                       \
+    ROS_STATIC_TASKS_BUDGET_ASSERT;                                                 \
+    constexpr ros_static_task_t ros_static_task_list[] = { __VA_ARGS__ };           \
+    static_assert(ros_static_tasks_in_order(ros_static_task_list),                  \
+                  "ROS_TASK PIDs must run 0, 1, 2, ... in order, below MAX_PROCESSES"); \
+    extern "C" {                                                                    \
+    process_t process_table[MAX_PROCESSES] = { __VA_ARGS__ };                       \
+    const int ros_static_task_count = sizeof(ros_static_task_list) / sizeof(ros_static_task_list[0]); \
+    }                                                                               \
+    static_assert(true, "takes the caller's semicolon")
+
+#endif
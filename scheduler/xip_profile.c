@@ -0,0 +1,69 @@
+#include "xip_profile.h"
+#include "ros_hot.h"
+#include "hardware/sync.h"
+
+static const char* const xip_profile_names[XIP_PROFILE_OPS] = {
+    "schedule", "resume", "unblock", "signal", "workqueue",
+};
+
+#if ROS_XIP_PROFILE
+
+// Clear the saturating counters once they pass this, long before they stick
+#define XIP_PROFILE_CLEAR_AT 0x80000000u
+
+// Per core, so updates only need interrupts off on the calling core
+static xip_profile_stats_t totals[NUM_CORES][XIP_PROFILE_OPS];
+
+void ROS_HOT(xip_profile_end)(xip_profile_op_t op, xip_profile_mark_t mark) {
+    uint32_t accesses = xip_ctrl_hw->ctr_acc;
+    uint32_t hits = xip_ctrl_hw->ctr_hit;
+
+    uint32_t irq = save_and_disable_interrupts();
+    // Below the mark: the counters were cleared mid-operation, the sample is lost
+    if (accesses >= mark.accesses && hits >= mark.hits) {
+        xip_profile_stats_t* t = &totals[get_core_num()][op];
+        t->calls++;
+        t->accesses += accesses - mark.accesses;
+        t->hits += hits - mark.hits;
+    }
+    if (accesses >= XIP_PROFILE_CLEAR_AT) {
+        xip_ctrl_hw->ctr_acc = 0;
+        xip_ctrl_hw->ctr_hit = 0;
+    }
+    restore_interrupts(irq);
+}
+
+void xip_profile_get(xip_profile_op_t op, xip_profile_stats_t* out) {
+    *out = (xip_profile_stats_t){0};
+    uint32_t irq = save_and_disable_interrupts();
+    for (uint c = 0; c < NUM_CORES; c++) {
+        out->calls += totals[c][op].calls;
+        out->accesses += totals[c][op].accesses;
+        out->hits += totals[c][op].hits;
+    }
+    restore_interrupts(irq);
+}
+
+void xip_profile_reset(void) {
+    uint32_t irq = save_and_disable_interrupts();
+    for (uint c = 0; c < NUM_CORES; c++)
+        for (int op = 0; op < XIP_PROFILE_OPS; op++) totals[c][op] = (xip_profile_stats_t){0};
+    xip_ctrl_hw->ctr_acc = 0;
+    xip_ctrl_hw->ctr_hit = 0;
+    restore_interrupts(irq);
+}
+
+#else
+
+void xip_profile_get(xip_profile_op_t op, xip_profile_stats_t* out) {
+    (void)op;
+    *out = (xip_profile_stats_t){0};
+}
+
+void xip_profile_reset(void) {}
+
+#endif
+
+const char* xip_profile_name(xip_profile_op_t op) {
+    return (unsigned)op < XIP_PROFILE_OPS ? xip_profile_names[op] : "?";
+}
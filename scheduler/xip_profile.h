@@ -0,0 +1,103 @@
+#pragma once
+/**
+ * @file xip_profile.h
+ * @brief XIP cache hit/access counts around kernel operations.
+ *
+ * With ROS_XIP_PROFILE=1 the kernel reads the XIP cache counters (CTR_ACC,
+ * CTR_HIT) at the start and end of each profiled operation and adds the
+ * difference to that operation's totals. Comparing builds with and without
+ * ROS_HOT_PATHS_IN_RAM shows how much of each path still fetches from flash:
+ * in the SRAM build `accesses` should fall to the flash calls that remain.
+ *
+ * The counters are shared by both cores and count every XIP access, so an
+ * operation that overlaps work on the other core picks up its accesses too.
+ * They saturate rather than wrap; xip_profile_end() clears them once they
+ * pass half range and drops the one sample that straddled the clear.
+ * With the option off (the default) the hooks compile to nothing.
+ */
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ROS_XIP_PROFILE
+#define ROS_XIP_PROFILE 0
+#endif
+
+/**
+ * @enum xip_profile_op_t
+ * @brief Profiled kernel operations.
+ *
+ * XIP_PROFILE_SCHEDULE  – schedule() up to the switch request: wake sleepers, ready check
+ * XIP_PROFILE_RESUME    – the context switch: hand back the outgoing process, pick, guard check
+ * XIP_PROFILE_UNBLOCK   – process_unblock(), usually from an interrupt handler
+ * XIP_PROFILE_SIGNAL    – semaphore release, mutex unlock, event flags set
+ * XIP_PROFILE_WORKQUEUE – workqueue_post()
+ */
+typedef enum {
+    XIP_PROFILE_SCHEDULE,
+    XIP_PROFILE_RESUME,
+    XIP_PROFILE_UNBLOCK,
+    XIP_PROFILE_SIGNAL,
+    XIP_PROFILE_WORKQUEUE,
+    XIP_PROFILE_OPS
+} xip_profile_op_t;
+
+/**
+ * @struct xip_profile_stats_t
+ * @brief Totals for one operation.
+ *
+ * calls    – samples counted
+ * accesses – XIP accesses during them (cache hits + misses)
+ * hits     – accesses served from the cache; accesses - hits went to flash
+ */
+typedef struct {
+    uint32_t calls;
+    uint32_t accesses;
+    uint32_t hits;
+} xip_profile_stats_t;
+
+#if ROS_XIP_PROFILE
+
+#include "hardware/structs/xip_ctrl.h"
+
+typedef struct {
+    uint32_t accesses;
+    uint32_t hits;
+} xip_profile_mark_t;
+
+/// @brief Snapshot the counters at the start of an operation.
+static inline xip_profile_mark_t xip_profile_begin(void) {
+    return (xip_profile_mark_t){ xip_ctrl_hw->ctr_acc, xip_ctrl_hw->ctr_hit };
+}
+
+/// @brief Add the counts since `mark` to operation `op`.
+void xip_profile_end(xip_profile_op_t op, xip_profile_mark_t mark);
+
+#else
+
+typedef int xip_profile_mark_t;
+
+static inline xip_profile_mark_t xip_profile_begin(void) { return 0; }
+static inline void xip_profile_end(xip_profile_op_t op, xip_profile_mark_t mark) { (void)op; (void)mark; }
+
+#endif
+
+/**
+ * @brief Copy out the totals of one operation (all zero when ROS_XIP_PROFILE is 0).
+ * @param op  Operation to read.
+ * @param out Destination.
+ */
+void xip_profile_get(xip_profile_op_t op, xip_profile_stats_t* out);
+
+/// @return Short name of `op` ("schedule", "resume", ...), for reports.
+const char* xip_profile_name(xip_profile_op_t op);
+
+/// @brief Clear all totals and the hardware counters.
+void xip_profile_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//-----------------------------------------------------------------------------
+// Master caution: fatal conditions detected by the kernel
+//-----------------------------------------------------------------------------
+typedef enum {
+    CAUTION_NONE,
+    CAUTION_STACK_OVERFLOW,     // Access to the MPU guard below a process or core stack
+    CAUTION_STACK_CANARY,       // Guard band canary overwritten
+} master_caution_reason_t;
+
+typedef struct {
+    master_caution_reason_t reason;
+    int pid;                    // Offending process, -1 if none
+    uint32_t detail;            // Reason-specific: faulting SP or corrupted address
+} master_caution_info_t;
+
+/// Last condition raised; read it from master_caution()
+extern volatile master_caution_info_t master_caution_info;
+
+/**
+ * @brief Record a condition and enter master_caution() through the SVC.
+ *
+ * From an interrupt or fault handler, where an SVC would escalate to a
+ * HardFault, master_caution() is called directly instead.
+ */
+void master_caution_raise(master_caution_reason_t reason, int pid, uint32_t detail);
+
+/**
+ * @brief SVC MASTER_CAUTION handler.
+ *
+ * Weak: the default panics with master_caution_info and ignores CAUTION_NONE.
+ * Override in your application to log, reset or kill the process instead.
+ */
+void master_caution(void);
+
+#ifdef __cplusplus
+}
+#endif
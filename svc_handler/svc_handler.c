@@ -12,9 +12,29 @@ static void software_reset(void)
 }
 
 
-static void master_caution(void) //yet to complete
+volatile master_caution_info_t master_caution_info = { CAUTION_NONE, -1, 0 };
+
+void master_caution_raise(master_caution_reason_t reason, int pid, uint32_t detail)
+{
+    master_caution_info.reason = reason;
+    master_caution_info.pid = pid;
+    master_caution_info.detail = detail;
+
+    // An SVC from handler mode escalates to HardFault, so call the handler directly there
+    if (__get_current_exception() == 0)
+        svc_call_master_caution();
+    else
+        master_caution();
+}
+
+
+__attribute__((weak)) void master_caution(void)
 {
-    // Default stub:  overridein your application, now modified with __attribute__((used));
+    // Default: stop with the reason. Override in your application.
+    if (master_caution_info.reason == CAUTION_NONE)
+        return;
+    panic("master caution %d: pid %d (0x%08lx)", (int)master_caution_info.reason,
+          master_caution_info.pid, (unsigned long)master_caution_info.detail);
 }
 
 
@@ -3,6 +3,7 @@
 #include "pico/stdlib.h"
 #include "pico/sleep.h"
 #include "ros_cmsis_compat.h"
+#include "master_caution.h"
 
 
 #ifdef __cplusplus
@@ -69,9 +70,9 @@ static inline void svc_call_go_to_dormant_gpio_irq(void) { (void)svc_comp_time(G
 
 //-----------------------------------------------------------------------------
 // 4. Handler prototypes (to be implemented by user or overridden)
+//    master_caution() is declared in master_caution.h
 //-----------------------------------------------------------------------------
 static void software_reset(void) __attribute__((used));
-static void master_caution(void) __attribute__((used));
 static void go_to_dormant_gpio_irq(uint8_t gpio_pin) __attribute__((used));
 
 #ifdef __cplusplus
@@ -0,0 +1,308 @@
+#include "telemetry.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/uart.h"
+#include <string.h>
+
+#define TELEMETRY_TX_MASK (TELEMETRY_TX_RING_SIZE - 1u)
+
+_Static_assert((TELEMETRY_TX_RING_SIZE & TELEMETRY_TX_MASK) == 0, "TELEMETRY_TX_RING_SIZE must be a power of two");
+_Static_assert(TELEMETRY_TX_RING_SIZE >= 2 * (TELEMETRY_MAX_ENCODED + 2), "TX ring must hold two full frames");
+_Static_assert(TELEMETRY_MAX_FRAME < 0xFF, "COBS must add exactly one byte, so ring space can be reserved before encoding");
+
+static const uint16_t telemetry_crc_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+typedef struct {
+    telemetry_handler_t handler;
+    void* ctx;
+    uint8_t tx_seq;
+    uint8_t rx_seq;
+    bool rx_seen;
+} telemetry_channel_t;
+
+static telemetry_channel_t telemetry_channels[TELEMETRY_MAX_CHANNELS];
+static telemetry_stats_t telemetry_stats;
+
+// ─────────────────────────────────────────────────────────────
+// TX ring (multi-producer, single consumer). Producers reserve space under the spin
+// lock and fill it outside; the consumer only sees bytes up to telemetry_tx_head,
+// which catches up with the reservations once no producer is still writing.
+static uint8_t telemetry_tx_ring[TELEMETRY_TX_RING_SIZE] __attribute__((aligned(4)));
+static uint32_t telemetry_tx_head;
+static uint32_t telemetry_tx_reserved;
+static uint32_t telemetry_tx_writers;
+static uint32_t telemetry_tx_tail;
+static spin_lock_t* telemetry_lock;
+
+static int telemetry_dma = -1;
+static uint32_t telemetry_dma_len;   // Bytes in flight, 0 when the channel is idle
+
+// ─────────────────────────────────────────────────────────────
+// RX framer
+static uint8_t telemetry_rx_buf[TELEMETRY_MAX_ENCODED];
+static size_t telemetry_rx_len;
+static bool telemetry_rx_in_frame;
+
+size_t telemetry_cobs_encode(const uint8_t* src, size_t len, uint8_t* dst) {
+    size_t code_at = 0;
+    size_t out = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < len; i++) {
+        if (src[i] == 0) {
+            dst[code_at] = code;
+            code_at = out++;
+            code = 1;
+            continue;
+        }
+        dst[out++] = src[i];
+        if (++code == 0xFF) {
+            dst[code_at] = code;
+            code_at = out++;
+            code = 1;
+        }
+    }
+    dst[code_at] = code;
+    return out;
+}
+
+int telemetry_cobs_decode(const uint8_t* src, size_t len, uint8_t* dst) {
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < len) {
+        uint8_t code = src[in++];
+        if (code == 0 || in + code - 1 > len) return -1;
+        for (uint8_t i = 1; i < code; i++) {
+            if (src[in] == 0) return -1;
+            dst[out++] = src[in++];
+        }
+        if (code != 0xFF && in < len) dst[out++] = 0;
+    }
+    return (int)out;
+}
+
+uint16_t telemetry_crc16(uint16_t crc, const uint8_t* data, size_t len) {
+    while (len--) crc = (uint16_t)((crc << 8) ^ telemetry_crc_table[(crc >> 8) ^ *data++]);
+    return crc;
+}
+
+// Start the next contiguous chunk if the DMA channel is idle (lock held)
+static void telemetry_dma_kick(void) {
+    if (telemetry_dma < 0 || telemetry_dma_len != 0 || telemetry_tx_head == telemetry_tx_tail) return;
+
+    uint32_t offset = telemetry_tx_tail & TELEMETRY_TX_MASK;
+    uint32_t len = telemetry_tx_head - telemetry_tx_tail;
+    if (len > TELEMETRY_TX_RING_SIZE - offset) len = TELEMETRY_TX_RING_SIZE - offset;
+
+    telemetry_dma_len = len;
+    dma_channel_transfer_from_buffer_now((uint)telemetry_dma, &telemetry_tx_ring[offset], len);
+}
+
+static void telemetry_dma_irq_handler(void) {
+    if (telemetry_dma < 0 || !dma_irqn_get_channel_status(1, (uint)telemetry_dma)) return;
+    dma_irqn_acknowledge_channel(1, (uint)telemetry_dma);
+
+    uint32_t irq = spin_lock_blocking(telemetry_lock);
+    telemetry_tx_tail += telemetry_dma_len;
+    telemetry_dma_len = 0;
+    telemetry_dma_kick();
+    spin_unlock(telemetry_lock, irq);
+}
+
+void telemetry_init(void) {
+    if (!telemetry_lock) telemetry_lock = spin_lock_instance((uint)spin_lock_claim_unused(true));
+
+    memset(telemetry_channels, 0, sizeof(telemetry_channels));
+    memset(&telemetry_stats, 0, sizeof(telemetry_stats));
+    telemetry_tx_head = telemetry_tx_reserved = telemetry_tx_tail = 0;
+    telemetry_tx_writers = 0;
+    telemetry_rx_len = 0;
+    telemetry_rx_in_frame = false;
+}
+
+void telemetry_init_uart_dma(uart_inst_t* uart) {
+    telemetry_init();
+
+    telemetry_dma = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config((uint)telemetry_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, uart_get_dreq(uart, true));
+    dma_channel_configure((uint)telemetry_dma, &c, &uart_get_hw(uart)->dr, telemetry_tx_ring, 0, false);
+
+    dma_irqn_set_channel_enabled(1, (uint)telemetry_dma, true);
+    irq_add_shared_handler(DMA_IRQ_1, telemetry_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+}
+
+void telemetry_register_channel(uint8_t channel, telemetry_handler_t handler, void* ctx) {
+    if (channel >= TELEMETRY_MAX_CHANNELS) return;
+    telemetry_channels[channel].ctx = ctx;
+    telemetry_channels[channel].handler = handler;
+}
+
+static void telemetry_loopback_handler(uint8_t channel, const uint8_t* data, size_t len, void* ctx) {
+    (void)ctx;
+    telemetry_send(channel, data, len);
+}
+
+void telemetry_enable_loopback(uint8_t channel) {
+    telemetry_register_channel(channel, telemetry_loopback_handler, NULL);
+}
+
+bool telemetry_send(uint8_t channel, const void* data, size_t len) {
+    if (!telemetry_lock || channel >= TELEMETRY_MAX_CHANNELS || len > TELEMETRY_MAX_PAYLOAD) return false;
+
+    uint8_t frame[TELEMETRY_MAX_FRAME];
+    uint8_t encoded[TELEMETRY_MAX_ENCODED + 2];
+    size_t n = len + TELEMETRY_FRAME_OVERHEAD + 3;   // COBS code byte and both delimiters
+
+    // The sequence number and the ring space are taken together, so a channel's
+    // frames sit in the ring in sequence order from any producer and a dropped
+    // frame never takes a number. CRC, COBS and the copy run outside the lock.
+    uint32_t irq = spin_lock_blocking(telemetry_lock);
+    if (TELEMETRY_TX_RING_SIZE - (telemetry_tx_reserved - telemetry_tx_tail) < n) {
+        telemetry_stats.tx_dropped++;
+        spin_unlock(telemetry_lock, irq);
+        return false;
+    }
+    uint32_t at = telemetry_tx_reserved;
+    telemetry_tx_reserved += n;
+    telemetry_tx_writers++;
+    frame[1] = telemetry_channels[channel].tx_seq++;
+    spin_unlock(telemetry_lock, irq);
+
+    frame[0] = channel;
+    memcpy(&frame[2], data, len);
+    uint16_t crc = telemetry_crc16(0xFFFF, frame, len + 2);
+    frame[len + 2] = (uint8_t)crc;
+    frame[len + 3] = (uint8_t)(crc >> 8);
+
+    // The leading zero is an empty frame: it closes any shell text before this one
+    encoded[0] = TELEMETRY_DELIMITER;
+    telemetry_cobs_encode(frame, len + TELEMETRY_FRAME_OVERHEAD, &encoded[1]);
+    encoded[n - 1] = TELEMETRY_DELIMITER;
+    for (size_t i = 0; i < n; i++) telemetry_tx_ring[(at + i) & TELEMETRY_TX_MASK] = encoded[i];
+
+    irq = spin_lock_blocking(telemetry_lock);
+    if (--telemetry_tx_writers == 0) telemetry_tx_head = telemetry_tx_reserved;
+    telemetry_stats.tx_frames++;
+    telemetry_dma_kick();
+    spin_unlock(telemetry_lock, irq);
+    return true;
+}
+
+void telemetry_flush(void) {
+    if (!telemetry_lock || telemetry_dma >= 0) return;
+
+    uint32_t irq = spin_lock_blocking(telemetry_lock);
+    uint32_t tail = telemetry_tx_tail;
+    uint32_t head = telemetry_tx_head;
+    spin_unlock(telemetry_lock, irq);
+
+    // Raw output: stdio CR/LF translation would corrupt binary frames
+    for (uint32_t i = tail; i != head; i++) putchar_raw(telemetry_tx_ring[i & TELEMETRY_TX_MASK]);
+
+    irq = spin_lock_blocking(telemetry_lock);
+    telemetry_tx_tail = head;
+    spin_unlock(telemetry_lock, irq);
+}
+
+// Check and dispatch a complete encoded frame; false if it was rejected
+static bool telemetry_rx_frame(void) {
+    int len = telemetry_cobs_decode(telemetry_rx_buf, telemetry_rx_len, telemetry_rx_buf);
+    if (len < (int)TELEMETRY_FRAME_OVERHEAD || telemetry_rx_buf[0] >= TELEMETRY_MAX_CHANNELS) {
+        telemetry_stats.rx_bad_frames++;
+        return false;
+    }
+
+    const uint8_t* f = telemetry_rx_buf;
+    uint16_t crc = (uint16_t)(f[len - 2] | (f[len - 1] << 8));
+    if (telemetry_crc16(0xFFFF, f, (size_t)len - 2) != crc) {
+        telemetry_stats.rx_crc_errors++;
+        return false;
+    }
+
+    telemetry_channel_t* ch = &telemetry_channels[f[0]];
+    if (ch->rx_seen) telemetry_stats.rx_seq_gaps += (uint8_t)(f[1] - (uint8_t)(ch->rx_seq + 1));
+    ch->rx_seq = f[1];
+    ch->rx_seen = true;
+    telemetry_stats.rx_frames++;
+
+    if (ch->handler) ch->handler(f[0], &f[2], (size_t)len - TELEMETRY_FRAME_OVERHEAD, ch->ctx);
+    return true;
+}
+
+bool telemetry_rx_feed(uint8_t c) {
+    if (!telemetry_rx_in_frame) {
+        if (c != TELEMETRY_DELIMITER) return false;
+        telemetry_rx_in_frame = true;
+        telemetry_rx_len = 0;
+        return true;
+    }
+
+    if (c == TELEMETRY_DELIMITER) {
+        // Every zero ends a frame. Empty frames (the zero sent ahead of each frame) are
+        // skipped. After a rejected frame, usually one that lost a byte, the zero may
+        // be the opener of the next frame, so framing stays armed. That resyncs on the
+        // next good frame instead of taking every later frame for shell text.
+        if (telemetry_rx_len > 0) telemetry_rx_in_frame = !telemetry_rx_frame();
+        telemetry_rx_len = 0;
+        return true;
+    }
+
+    if (telemetry_rx_len == sizeof(telemetry_rx_buf)) {
+        // Longer than any frame: shell text after a stray zero. Give the link back to the shell.
+        telemetry_stats.rx_bad_frames++;
+        telemetry_rx_in_frame = false;
+        return false;
+    }
+    telemetry_rx_buf[telemetry_rx_len++] = c;
+    return true;
+}
+
+void telemetry_get_stats(telemetry_stats_t* out) {
+    if (!telemetry_lock) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    uint32_t irq = spin_lock_blocking(telemetry_lock);
+    *out = telemetry_stats;
+    spin_unlock(telemetry_lock, irq);
+}
@@ -0,0 +1,172 @@
+#pragma once
+/**
+ * @file telemetry.h
+ * @brief Framed binary telemetry and command channels.
+ *
+ * Frames are COBS-encoded and terminated by 0x00. The sender also puts a
+ * 0x00 (an empty frame) ahead of each one, so with the stdio transport they
+ * share the ASCII terminal's USB or UART link: the text shell never contains
+ * 0x00, and terminal_update() hands the bytes from a zero up to the end of
+ * the frame to telemetry_rx_feed() without echoing them.
+ *
+ * Decoded frame layout:
+ *
+ *     channel (1) | seq (1) | payload (0..TELEMETRY_MAX_PAYLOAD) | CRC-16 (2, LE)
+ *
+ * The CRC is CRC-16/CCITT-FALSE over channel, seq and payload. Each channel
+ * keeps its own 8-bit sequence counter so the receiver can count lost frames.
+ * Numbers are taken as ring space is reserved, so they stay in order with
+ * several producers on a channel.
+ *
+ * Outgoing frames are encoded into a TX ring and drained either through
+ * stdio (telemetry_flush(), raw bytes without CR/LF translation) or by a DMA
+ * channel feeding a UART (telemetry_init_uart_dma()).
+ */
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Largest payload carried by one frame
+#define TELEMETRY_MAX_PAYLOAD 250u
+
+/// Number of multiplexed channels (IDs 0 .. TELEMETRY_MAX_CHANNELS - 1)
+#ifndef TELEMETRY_MAX_CHANNELS
+#define TELEMETRY_MAX_CHANNELS 16u
+#endif
+
+/// TX ring size in bytes (power of two)
+#ifndef TELEMETRY_TX_RING_SIZE
+#define TELEMETRY_TX_RING_SIZE 2048u
+#endif
+
+#define TELEMETRY_DELIMITER 0x00u
+#define TELEMETRY_FRAME_OVERHEAD 4u   // channel, seq, CRC-16
+#define TELEMETRY_MAX_FRAME (TELEMETRY_MAX_PAYLOAD + TELEMETRY_FRAME_OVERHEAD)
+#define TELEMETRY_MAX_ENCODED (TELEMETRY_MAX_FRAME + TELEMETRY_MAX_FRAME / 254u + 1u)
+
+/**
+ * @brief Handler for frames received on a channel.
+ * @param channel Channel the frame arrived on.
+ * @param data Payload (valid only during the call).
+ * @param len Payload length.
+ * @param ctx Context pointer given at registration.
+ */
+typedef void (*telemetry_handler_t)(uint8_t channel, const uint8_t* data, size_t len, void* ctx);
+
+/**
+ * @struct telemetry_stats_t
+ * @brief Link counters.
+ *
+ * tx_frames       – frames queued for transmission
+ * tx_dropped      – frames rejected because the TX ring was full
+ * rx_frames       – frames received with a valid CRC
+ * rx_crc_errors   – frames discarded for a CRC mismatch
+ * rx_bad_frames   – frames discarded for bad COBS, length or unknown channel
+ * rx_seq_gaps     – frames missing according to the per-channel sequence
+ */
+typedef struct {
+    uint32_t tx_frames;
+    uint32_t tx_dropped;
+    uint32_t rx_frames;
+    uint32_t rx_crc_errors;
+    uint32_t rx_bad_frames;
+    uint32_t rx_seq_gaps;
+} telemetry_stats_t;
+
+/**
+ * @brief COBS-encode a buffer (no delimiter is appended).
+ * @param src Input bytes.
+ * @param len Input length.
+ * @param dst Output, at least len + len / 254 + 1 bytes.
+ * @return Encoded length.
+ */
+size_t telemetry_cobs_encode(const uint8_t* src, size_t len, uint8_t* dst);
+
+/**
+ * @brief Decode a COBS buffer (without delimiter).
+ * @param src Encoded bytes.
+ * @param len Encoded length.
+ * @param dst Output, at least len bytes. May alias src.
+ * @return Decoded length, or -1 if the encoding is invalid.
+ */
+int telemetry_cobs_decode(const uint8_t* src, size_t len, uint8_t* dst);
+
+/// @brief CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), continued from `crc`.
+uint16_t telemetry_crc16(uint16_t crc, const uint8_t* data, size_t len);
+
+/**
+ * @brief Reset link state and drain outgoing frames through stdio.
+ *
+ * Call telemetry_flush() periodically (the terminal does so in terminal_update()).
+ */
+void telemetry_init(void);
+
+/**
+ * @brief Drain outgoing frames to a UART by DMA instead of stdio.
+ *
+ * Claims a DMA channel paced by the UART TX DREQ and completes through a
+ * shared DMA_IRQ_1 handler. The UART must already be initialized.
+ *
+ * The UART then carries telemetry only: stdio output does not go through the
+ * TX ring and would land in the middle of frames, so keep the shell on USB or
+ * another UART.
+ *
+ * @param uart UART instance (uart0 or uart1).
+ */
+void telemetry_init_uart_dma(uart_inst_t* uart);
+
+/**
+ * @brief Install the handler for frames received on a channel.
+ * @param channel Channel ID.
+ * @param handler Handler, or NULL to drop frames on the channel.
+ * @param ctx Context pointer passed to the handler.
+ */
+void telemetry_register_channel(uint8_t channel, telemetry_handler_t handler, void* ctx);
+
+/**
+ * @brief Echo every frame received on a channel back on the same channel.
+ *
+ * Used by the host client's throughput benchmark.
+ */
+void telemetry_enable_loopback(uint8_t channel);
+
+/**
+ * @brief Queue one frame for transmission. Safe from any core and from IRQs.
+ *
+ * The spin lock is only held to reserve ring space and publish it; the CRC,
+ * COBS encoding and copy run with interrupts enabled.
+ * @param channel Channel ID.
+ * @param data Payload.
+ * @param len Payload length (at most TELEMETRY_MAX_PAYLOAD).
+ * @return true if queued, false if the ring is full or the arguments are invalid.
+ */
+bool telemetry_send(uint8_t channel, const void* data, size_t len);
+
+/**
+ * @brief Write queued frames to stdio (no-op when the DMA transport is active).
+ */
+void telemetry_flush(void);
+
+/**
+ * @brief Feed one received byte to the framer.
+ *
+ * A 0x00 outside a frame opens one; bytes up to the next 0x00 are collected,
+ * then the frame is checked and dispatched to its channel handler. Every
+ * 0x00 ends a frame. After a frame fails its checks (typically a lost byte),
+ * framing stays armed, so the receiver is back in step on the next good frame.
+ * A run longer than any frame is handed back to the shell.
+ *
+ * @param c Received byte.
+ * @return true if the byte belongs to a frame, false if it is shell text.
+ */
+bool telemetry_rx_feed(uint8_t c);
+
+/// @brief Copy the link counters.
+void telemetry_get_stats(telemetry_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
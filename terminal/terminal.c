@@ -1,21 +1,57 @@
 #include "terminal.h"
+#include "telemetry.h"
 #include <stdio.h>
 #include <string.h>
 
-static void terminal_init(Terminal* t) {
+void terminal_init(Terminal* t) {
     t->index = 0;
     t->command_ready = false;
     t->buffer[0] = '\0';
     t->command[0] = '\0';
     t->payload[0] = '\0';
+    t->registry = NULL;
     printf("-> ");
 }
 
-static void terminal_update(Terminal* t) {
+void terminal_set_registry(Terminal* t, const terminal_registry_t* registry) {
+    t->registry = registry;
+}
+
+// Complete the command name typed so far (only before the first space)
+static void terminal_complete(Terminal* t) {
+    if (t->index == 0 || memchr(t->buffer, ' ', t->index)) return;
+
+    const char* match;
+    int matches = terminal_registry_complete(t->registry, t->buffer, t->index, &match);
+    if (matches == 1) {
+        for (const char* p = match + t->index; *p && t->index < TERMINAL_MAX_LEN - 2; p++) {
+            t->buffer[t->index++] = *p;
+            putchar(*p);
+        }
+        t->buffer[t->index++] = ' ';
+        putchar(' ');
+    } else if (matches > 1) {
+        printf("\n");
+        terminal_registry_print_matches(t->registry, t->buffer, t->index);
+        t->buffer[t->index] = '\0';
+        printf("-> %s", t->buffer);
+    }
+}
+
+void terminal_update(Terminal* t) {
     int c;
     while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+        // Binary frames (0x00 ... 0x00) go to the telemetry framer, never echoed
+        if (telemetry_rx_feed((uint8_t)c)) continue;
+
         if (c == '\r' || c == '\n') {
-            if (t->index > 0) {
+            if (t->index > 0 && t->registry) {
+                t->buffer[t->index] = '\0';
+                printf("\n");
+                terminal_registry_dispatch(t->registry, t->buffer);
+                printf("-> ");
+                t->index = 0;
+            } else if (t->index > 0) {
                 t->buffer[t->index] = '\0';
 
                 // Parse command and payload
@@ -35,7 +71,10 @@ static void terminal_update(Terminal* t) {
                 printf("Payload: %s\n", t->payload);
                 printf("-> ");
                 t->index = 0;
+                break;  // Leave further input queued until this command is collected
             }
+        } else if (c == '\t' && t->registry) {
+            terminal_complete(t);
         } else {
             if (t->index < TERMINAL_MAX_LEN - 1) {
                 t->buffer[t->index++] = (char)c;
@@ -43,17 +82,18 @@ static void terminal_update(Terminal* t) {
             }
         }
     }
+    telemetry_flush();
 }
 
-static bool terminal_has_command(Terminal* t) {
+bool terminal_has_command(Terminal* t) {
     return t->command_ready;
 }
 
-static char* terminal_get_command(Terminal* t) {
+char* terminal_get_command(Terminal* t) {
     t->command_ready = false;
     return t->command;
 }
 
-static char* terminal_get_payload(Terminal* t) {
+char* terminal_get_payload(Terminal* t) {
     return t->payload;
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "pico/stdlib.h"  // Pico SDK stdio and basic definitions
+#include "terminal_commands.h"
 
 /// Maximum number of characters (including terminating '\0') the input buffer can hold.
 #define TERMINAL_MAX_LEN 256
@@ -23,6 +24,7 @@
  * command_ready  – true when a full line (command + payload) is parsed 
  * command[64]    – NUL-terminated first token (the command keyword)  
  * payload[192]   – NUL-terminated remainder of the line  
+ * registry       – command registry to dispatch through, or NULL for command/payload mode  
  */
 typedef struct {
     char buffer[TERMINAL_MAX_LEN];
@@ -30,6 +32,7 @@ typedef struct {
     bool command_ready;
     char command[64];
     char payload[192];
+    const terminal_registry_t* registry;
 } Terminal;
 
 /**
@@ -39,7 +42,7 @@ typedef struct {
  *
  * @param t Pointer to the Terminal instance to initialize.
  */
-static void terminal_init(Terminal* t) __attribute__((no_inline));
+void terminal_init(Terminal* t) __attribute__((noinline));
 
 /**
  * @brief Read and process incoming characters from USB STDIO.
@@ -52,10 +55,29 @@ static void terminal_init(Terminal* t) __attribute__((no_inline));
  *   - Sets command_ready flag.  
  *   - Prints parsed command, payload, and reprints "-> " prompt.  
  *   - Resets index to 0 for next line.  
+ *   - Returns, leaving later input unread until the command is collected.  
+ *
+ * When a registry is set, the line is instead tokenized in place and
+ * dispatched to its handler, and Tab completes the command name.
+ *
+ * Bytes from a 0x00 to the 0x00 that terminates the frame are binary
+ * telemetry; they are passed to telemetry_rx_feed() without echo. Queued outgoing frames are
+ * flushed before returning.
  *
  * @param t Pointer to the Terminal instance to update.
  */
-static void terminal_update(Terminal* t) __attribute__((no_inline));
+void terminal_update(Terminal* t) __attribute__((noinline));
+
+/**
+ * @brief Dispatch completed lines through a command registry.
+ *
+ * Enables tab completion and the built-in `help` command. Pass NULL to return
+ * to command/payload mode.
+ *
+ * @param t Pointer to the Terminal instance.
+ * @param registry Registry built with ROHINI_COMMAND_REGISTRY, or NULL.
+ */
+void terminal_set_registry(Terminal* t, const terminal_registry_t* registry) __attribute__((noinline));
 
 /**
  * @brief Query whether a complete command has been received.
@@ -66,7 +88,7 @@ static void terminal_update(Terminal* t) __attribute__((no_inline));
  * @return true if a command+payload pair is ready to be handled.
  * @return false otherwise.
  */
-static bool terminal_has_command(Terminal* t) __attribute__((no_inline));
+bool terminal_has_command(Terminal* t) __attribute__((noinline));
 
 /**
  * @brief Retrieve the parsed command token.
@@ -76,7 +98,7 @@ static bool terminal_has_command(Terminal* t) __attribute__((no_inline));
  * @param t Pointer to the Terminal instance.
  * @return Pointer to a NUL-terminated string containing the command.
  */
-static char* terminal_get_command(Terminal* t) __attribute__((no_inline));
+char* terminal_get_command(Terminal* t) __attribute__((noinline));
 
 /**
  * @brief Retrieve the payload string (everything after the command token).
@@ -86,4 +108,4 @@ static char* terminal_get_command(Terminal* t) __attribute__((no_inline));
  * @param t Pointer to the Terminal instance.
  * @return Pointer to a NUL-terminated string containing the payload.
  */
-static char* terminal_get_payload(Terminal* t);
\ No newline at end of file
+char* terminal_get_payload(Terminal* t);
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "terminal_commands.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char terminal_help_name[] = "help";
+
+const terminal_command_t* terminal_registry_find(const terminal_registry_t* registry, const char* name) {
+    uint32_t h = terminal_hash_name(name);
+    uint32_t seed = registry->seeds[terminal_hash_bucket(h, registry->bucket_mask)];
+    uint16_t index = registry->slots[terminal_hash_slot(h, seed, registry->slot_mask)];
+    if (index == TERMINAL_SLOT_EMPTY) return NULL;
+
+    const terminal_command_t* cmd = &registry->commands[index];
+    return strcmp(cmd->name, name) == 0 ? cmd : NULL;
+}
+
+int terminal_tokenize(char* line, char** argv, int max_args) {
+    int argc = 0;
+    char* p = line;
+    while (*p && argc < max_args) {
+        while (*p == ' ' || *p == '\t') *p++ = '\0';
+        if (!*p) break;
+        argv[argc++] = p;
+        while (*p && *p != ' ' && *p != '\t') p++;
+    }
+    return argc;
+}
+
+void terminal_registry_help(const terminal_registry_t* registry) {
+    printf("  %-16s %s\n", terminal_help_name, "List commands");
+    for (uint16_t i = 0; i < registry->count; i++) {
+        const terminal_command_t* cmd = &registry->commands[i];
+        printf("  %-16s %s\n", cmd->name, cmd->help ? cmd->help : "");
+    }
+}
+
+int terminal_registry_dispatch(const terminal_registry_t* registry, char* line) {
+    char* argv[TERMINAL_MAX_ARGS];
+    int argc = terminal_tokenize(line, argv, TERMINAL_MAX_ARGS);
+    if (argc == 0) return 0;
+
+    const terminal_command_t* cmd = terminal_registry_find(registry, argv[0]);
+    if (cmd) return cmd->handler(argc, argv);
+
+    if (strcmp(argv[0], terminal_help_name) == 0) {
+        terminal_registry_help(registry);
+        return 0;
+    }
+
+    printf("Unknown command: %s\n", argv[0]);
+    return -1;
+}
+
+int terminal_registry_complete(const terminal_registry_t* registry, const char* prefix, size_t len, const char** match) {
+    int matches = 0;
+    *match = NULL;
+
+    if (strncmp(terminal_help_name, prefix, len) == 0) {
+        *match = terminal_help_name;
+        matches++;
+    }
+    for (uint16_t i = 0; i < registry->count; i++) {
+        const char* name = registry->commands[i].name;
+        if (strncmp(name, prefix, len) == 0) {
+            if (!*match) *match = name;
+            matches++;
+        }
+    }
+    return matches;
+}
+
+void terminal_registry_print_matches(const terminal_registry_t* registry, const char* prefix, size_t len) {
+    if (strncmp(terminal_help_name, prefix, len) == 0) printf("%s  ", terminal_help_name);
+    for (uint16_t i = 0; i < registry->count; i++) {
+        const char* name = registry->commands[i].name;
+        if (strncmp(name, prefix, len) == 0) printf("%s  ", name);
+    }
+    printf("\n");
+}
@@ -0,0 +1,153 @@
+/**
+ * @file terminal_commands.h
+ * @brief Static command registry with perfect-hash dispatch for the terminal shell.
+ *
+ * Commands are declared in a constant table. The C++ builder in
+ * terminal_commands.hpp computes a two-level perfect hash for the table at
+ * compile time, so looking up a command costs one pass over its name, two
+ * table reads and a single string compare, however many commands exist.
+ * Lines are tokenized in place into argv; nothing is copied.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Maximum number of tokens (command included) passed to a handler
+#ifndef TERMINAL_MAX_ARGS
+#define TERMINAL_MAX_ARGS 16
+#endif
+
+/// Marks an unused slot in terminal_registry_t::slots
+#define TERMINAL_SLOT_EMPTY 0xFFFFu
+
+#ifdef __cplusplus
+#define TERMINAL_CONSTEXPR constexpr
+#else
+#define TERMINAL_CONSTEXPR
+#endif
+
+/**
+ * @brief Command handler.
+ * @param argc Number of tokens, including the command name.
+ * @param argv Tokens; argv[0] is the command name. Points into the line buffer.
+ * @return 0 on success, non-zero error code otherwise.
+ */
+typedef int (*terminal_handler_t)(int argc, char** argv);
+
+/**
+ * @struct terminal_command_t
+ * @brief One entry of the command table.
+ *
+ * name     – command keyword
+ * handler  – function invoked with the tokenized line
+ * help     – one-line description shown by the built-in `help`
+ */
+typedef struct {
+    const char* name;
+    terminal_handler_t handler;
+    const char* help;
+} terminal_command_t;
+
+/**
+ * @struct terminal_registry_t
+ * @brief Command table plus its perfect-hash index (built by terminal_commands.hpp).
+ *
+ * commands     – command table
+ * count        – number of commands
+ * bucket_mask  – number of first-level buckets minus one (power of two)
+ * slot_mask    – number of slots minus one (power of two)
+ * seeds        – per-bucket seed for the second-level hash
+ * slots        – slot to command index, TERMINAL_SLOT_EMPTY if unused
+ */
+typedef struct {
+    const terminal_command_t* commands;
+    uint16_t count;
+    uint16_t bucket_mask;
+    uint16_t slot_mask;
+    const uint16_t* seeds;
+    const uint16_t* slots;
+} terminal_registry_t;
+
+// FNV-1a over a NUL-terminated name
+static inline TERMINAL_CONSTEXPR uint32_t terminal_hash_name(const char* s) {
+    uint32_t h = 2166136261u;
+    while (*s) {
+        h ^= (uint8_t)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// First-level bucket, taken from the high half of the name hash
+static inline TERMINAL_CONSTEXPR uint32_t terminal_hash_bucket(uint32_t h, uint32_t bucket_mask) {
+    return (h >> 16) & bucket_mask;
+}
+
+// Second-level slot: seeded 32-bit finalizer over the name hash
+static inline TERMINAL_CONSTEXPR uint32_t terminal_hash_slot(uint32_t h, uint32_t seed, uint32_t slot_mask) {
+    h ^= seed * 0x9E3779B9u;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h & slot_mask;
+}
+
+/**
+ * @brief Look up a command by name in constant time.
+ * @param registry Registry to search.
+ * @param name NUL-terminated command name.
+ * @return Matching entry, or NULL if unknown.
+ */
+const terminal_command_t* terminal_registry_find(const terminal_registry_t* registry, const char* name);
+
+/**
+ * @brief Split a line into whitespace-separated tokens in place.
+ *
+ * Separators are overwritten with NUL and argv points into the line.
+ *
+ * @param line Line to tokenize (modified).
+ * @param argv Output token array.
+ * @param max_args Capacity of argv.
+ * @return Number of tokens.
+ */
+int terminal_tokenize(char* line, char** argv, int max_args);
+
+/**
+ * @brief Tokenize a line and run its command.
+ *
+ * `help` is built in and lists every registered command.
+ *
+ * @param registry Registry to dispatch through.
+ * @param line Line to execute (modified by tokenization).
+ * @return Handler result, 0 for an empty line, -1 for an unknown command.
+ */
+int terminal_registry_dispatch(const terminal_registry_t* registry, char* line);
+
+/// @brief Print every command with its help text.
+void terminal_registry_help(const terminal_registry_t* registry);
+
+/**
+ * @brief Find commands starting with a prefix (for tab completion).
+ * @param registry Registry to search.
+ * @param prefix Prefix characters (need not be NUL-terminated).
+ * @param len Prefix length.
+ * @param match Output: first matching command name, or NULL.
+ * @return Number of matching commands (including the built-in `help`).
+ */
+int terminal_registry_complete(const terminal_registry_t* registry, const char* prefix, size_t len, const char** match);
+
+/// @brief Print every command starting with a prefix on one line.
+void terminal_registry_print_matches(const terminal_registry_t* registry, const char* prefix, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,142 @@
+#pragma once
+/**
+ * @file terminal_commands.hpp
+ * @brief Compile-time perfect-hash builder for terminal command tables.
+ *
+ * Usage:
+ * @code
+ * static constexpr terminal_command_t shell_commands[] = {
+ *     { "led",    cmd_led,    "led <on|off>" },
+ *     { "reboot", cmd_reboot, "Reset the board" },
+ * };
+ * ROHINI_COMMAND_REGISTRY(shell_registry, shell_commands);
+ *
+ * terminal_set_registry(&term, &shell_registry);
+ * @endcode
+ *
+ * The builder uses hash-and-displace: names are spread over buckets by the
+ * high half of their hash, then each bucket (largest first) gets the first
+ * seed that maps all of its names to free slots. Duplicate names, hash
+ * collisions or an unsolvable table fail the build through static_assert.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "terminal_commands.h"
+
+namespace rohini {
+
+constexpr std::size_t command_pow2_ceil(std::size_t n) {
+    std::size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+template <std::size_t N>
+struct CommandRegistry {
+    // ~4 names per bucket, load factor at most 0.5
+    static constexpr std::size_t buckets = command_pow2_ceil((N + 3) / 4);
+    static constexpr std::size_t slots = command_pow2_ceil(N) * 2;
+    static constexpr uint32_t max_seed = 0xFFFFu;
+
+    std::array<uint16_t, buckets> seeds{};
+    std::array<uint16_t, slots> slot_table{};
+    bool ok = false;
+
+    constexpr terminal_registry_t view(const terminal_command_t (&commands)[N]) const {
+        return terminal_registry_t{
+            commands,
+            static_cast<uint16_t>(N),
+            static_cast<uint16_t>(buckets - 1),
+            static_cast<uint16_t>(slots - 1),
+            seeds.data(),
+            slot_table.data(),
+        };
+    }
+};
+
+template <std::size_t N>
+constexpr CommandRegistry<N> make_command_registry(const terminal_command_t (&commands)[N]) {
+    static_assert(N > 0, "command table is empty");
+    static_assert(N < TERMINAL_SLOT_EMPTY, "too many commands");
+
+    using Registry = CommandRegistry<N>;
+    Registry reg{};
+
+    std::array<uint32_t, N> hashes{};
+    std::array<std::size_t, Registry::buckets> bucket_size{};
+    for (std::size_t i = 0; i < N; i++) {
+        hashes[i] = terminal_hash_name(commands[i].name);
+        bucket_size[terminal_hash_bucket(hashes[i], Registry::buckets - 1)]++;
+    }
+
+    // Two names with the same 32-bit hash can never be separated
+    for (std::size_t i = 0; i < N; i++) {
+        for (std::size_t j = i + 1; j < N; j++) {
+            if (hashes[i] == hashes[j]) return reg;
+        }
+    }
+
+    for (std::size_t s = 0; s < Registry::slots; s++) reg.slot_table[s] = TERMINAL_SLOT_EMPTY;
+
+    // Place buckets largest first
+    std::array<std::size_t, Registry::buckets> order{};
+    for (std::size_t b = 0; b < Registry::buckets; b++) order[b] = b;
+    for (std::size_t i = 0; i < Registry::buckets; i++) {
+        for (std::size_t j = i + 1; j < Registry::buckets; j++) {
+            if (bucket_size[order[j]] > bucket_size[order[i]]) {
+                std::size_t t = order[i];
+                order[i] = order[j];
+                order[j] = t;
+            }
+        }
+    }
+
+    for (std::size_t o = 0; o < Registry::buckets; o++) {
+        std::size_t b = order[o];
+        if (bucket_size[b] == 0) break;
+
+        bool placed = false;
+        for (uint32_t seed = 0; seed <= Registry::max_seed && !placed; seed++) {
+            std::array<std::size_t, N> taken{};
+            std::size_t n = 0;
+            bool fits = true;
+            for (std::size_t i = 0; i < N && fits; i++) {
+                if (terminal_hash_bucket(hashes[i], Registry::buckets - 1) != b) continue;
+                std::size_t slot = terminal_hash_slot(hashes[i], seed, Registry::slots - 1);
+                if (reg.slot_table[slot] != TERMINAL_SLOT_EMPTY) fits = false;
+                for (std::size_t k = 0; k < n && fits; k++) {
+                    if (taken[k] == slot) fits = false;
+                }
+                taken[n++] = slot;
+            }
+            if (!fits) continue;
+
+            std::size_t k = 0;
+            for (std::size_t i = 0; i < N; i++) {
+                if (terminal_hash_bucket(hashes[i], Registry::buckets - 1) != b) continue;
+                reg.slot_table[taken[k++]] = static_cast<uint16_t>(i);
+            }
+            reg.seeds[b] = static_cast<uint16_t>(seed);
+            placed = true;
+        }
+        if (!placed) return reg;
+    }
+
+    reg.ok = true;
+    return reg;
+}
+
+} // namespace rohini
+
+/**
+ * @brief Define a terminal_registry_t named `name` for a constexpr command table.
+ *
+ * Fails to compile if the table holds duplicate names or no perfect hash is found.
+ */
+#define ROHINI_COMMAND_REGISTRY(name, table)                                              \
+    static constexpr auto name##_index = rohini::make_command_registry(table);           \
+    static_assert(name##_index.ok, "no perfect hash for " #table " (duplicate names?)"); \
+    static constexpr terminal_registry_t name = name##_index.view(table)
@@ -1,76 +1,118 @@
 #include "terminal_core.h"
 #include "terminal.h"
-#include "pico/multicore.h"
+#include "scheduler.h"
+#include "hardware/sync.h"
 #include <string.h>
 #include <stdio.h>
 
+_Static_assert((TERMINAL_CORE_QUEUE_LEN & (TERMINAL_CORE_QUEUE_LEN - 1)) == 0,
+               "TERMINAL_CORE_QUEUE_LEN must be a power of two");
+
 terminal_core_state_t terminal_state = {
-    .last_command = {0},
-    .last_payload = {0},
-    .command_ready = false
+    .head = 0,
+    .tail = 0,
+    .dropped = 0,
+    .consumer_pid = -1,
+    .pid = -1
 };
 
-static void terminal_core_loop() {
-    Terminal term;
-    terminal_init(&term);
-
-    while (true) {
-        terminal_update(&term);
+static Terminal terminal_core_term;
 
-        if (terminal_has_command(&term)) {
-            // Read and store command + payload
-            const char* cmd = terminal_get_command(&term);
-            const char* payload = terminal_get_payload(&term);
+// stdio RX interrupt / USB task: runs outside process context
+static void terminal_core_chars_available(void* param) {
+    (void)param;
+    process_unblock(terminal_state.pid);
+}
 
-            strncpy(terminal_state.last_command, cmd, TERMINAL_CMD_MAX_LEN - 1);
-            terminal_state.last_command[TERMINAL_CMD_MAX_LEN - 1] = '\0';
+static void terminal_core_push(const char* cmd, const char* payload) {
+    if (terminal_state.head - terminal_state.tail >= TERMINAL_CORE_QUEUE_LEN) {
+        terminal_state.dropped++;
+        printf("Command queue full, dropped: %s\n", cmd);
+        return;
+    }
 
-            strncpy(terminal_state.last_payload, payload, TERMINAL_PAYLOAD_MAX_LEN - 1);
-            terminal_state.last_payload[TERMINAL_PAYLOAD_MAX_LEN - 1] = '\0';
+    terminal_core_entry_t* e = &terminal_state.queue[terminal_state.head % TERMINAL_CORE_QUEUE_LEN];
+    strncpy(e->command, cmd, TERMINAL_CMD_MAX_LEN - 1);
+    e->command[TERMINAL_CMD_MAX_LEN - 1] = '\0';
+    strncpy(e->payload, payload, TERMINAL_PAYLOAD_MAX_LEN - 1);
+    e->payload[TERMINAL_PAYLOAD_MAX_LEN - 1] = '\0';
 
-            terminal_state.command_ready = true;
+    __dmb();  // Entry visible before the consumer sees the new head
+    terminal_state.head++;
+    process_unblock(terminal_state.consumer_pid);
+}
 
-            // Optional: Echo command confirmation
-            terminal_write(&term, "Command received\r\n");
+// One pass per dispatch: drain the input, then block until the next RX notification
+static void terminal_core_process(void) {
+    do {
+        // terminal_update() stops after each complete line, so keep going until the input is drained
+        terminal_update(&terminal_core_term);
+        while (terminal_has_command(&terminal_core_term)) {
+            terminal_core_push(terminal_get_command(&terminal_core_term), terminal_get_payload(&terminal_core_term));
+            terminal_update(&terminal_core_term);
         }
-    }
+    } while (!process_block());   // false: characters arrived during the drain
+}
+
+int terminal_core_launch(void) {
+    terminal_init(&terminal_core_term);
+    terminal_state.pid = create_process(terminal_core_process, TERMINAL_CORE_PRIORITY);
+    if (terminal_state.pid >= 0) stdio_set_chars_available_callback(terminal_core_chars_available, NULL);
+    return terminal_state.pid;
+}
+
+bool terminal_core_next(terminal_core_entry_t* out) {
+    if (terminal_state.tail == terminal_state.head) return false;
+
+    __dmb();  // Read the entry only after observing the head that published it
+    *out = terminal_state.queue[terminal_state.tail % TERMINAL_CORE_QUEUE_LEN];
+    __dmb();
+    terminal_state.tail++;
+    return true;
 }
 
-void terminal_core_launch(void) {
-    multicore_launch_core1(terminal_core_loop);
+uint32_t terminal_core_pending(void) {
+    return terminal_state.head - terminal_state.tail;
+}
+
+void terminal_core_set_consumer(int pid) {
+    terminal_state.consumer_pid = pid;
 }
 
 /*
 
 example
 
-#include "terminal_core.h"
-#include "pico/stdlib.h"
+#include "kernel.h"
 #include <stdio.h>
 #include <string.h>
 
-int main() {
-    stdio_init_all();
-    terminal_core_launch();  // Run terminal on Core 1
+using namespace rohini;
+
+void app_task() {
+    terminal_core_entry_t cmd;
 
-    while (true) {
-        if (terminal_state.command_ready) {
-            printf("Command: %s\n", terminal_state.last_command);
-            printf("Payload: %s\n", terminal_state.last_payload);
+    // One pass per dispatch; the terminal unblocks this process when a command arrives
+    do {
+        while (terminal_core_next(&cmd)) {
+            printf("Command: %s\n", cmd.command);
+            printf("Payload: %s\n", cmd.payload);
 
             // Example: react to a specific command
-            if (strcmp(terminal_state.last_command, "blink") == 0) {
+            if (strcmp(cmd.command, "blink") == 0) {
                 // Do something like toggling an LED
                 printf("Blinking LED...\n");
             }
-
-            terminal_state.command_ready = false; // Reset after handling
         }
+    } while (!process_block());
+}
 
-        sleep_ms(100);  // Core 0 polling loop
-    }
-
-    return 0;
+int main() {
+    Kernel::init();
+    terminal_core_set_consumer(Kernel::create(app_task, 1));
+    terminal_core_launch();  // Low-priority terminal process
+    Kernel::launch_core1();
+    Kernel::run();
 }
 
 
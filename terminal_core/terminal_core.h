@@ -11,33 +11,86 @@ extern "C" {
 #define TERMINAL_CMD_MAX_LEN     64
 #define TERMINAL_PAYLOAD_MAX_LEN 192
 
+/// Number of received commands that can wait for the application (power of two)
+#ifndef TERMINAL_CORE_QUEUE_LEN
+#define TERMINAL_CORE_QUEUE_LEN  8
+#endif
+
+/// Scheduling priority of the terminal process (below the default of create_init_process)
+#ifndef TERMINAL_CORE_PRIORITY
+#define TERMINAL_CORE_PRIORITY   0
+#endif
+
 /**
- * @struct terminal_core_state_t
- * @brief Shared state between Core 0 and Core 1 terminal loop.
+ * @struct terminal_core_entry_t
+ * @brief One received command.
  */
 typedef struct {
     /// Command received from user input (e.g., "start", "led_on", etc.)
-    char last_command[TERMINAL_CMD_MAX_LEN];
+    char command[TERMINAL_CMD_MAX_LEN];
 
     /// Payload after the command (e.g., "arg1 arg2")
-    char last_payload[TERMINAL_PAYLOAD_MAX_LEN];
+    char payload[TERMINAL_PAYLOAD_MAX_LEN];
+} terminal_core_entry_t;
+
+/**
+ * @struct terminal_core_state_t
+ * @brief Command queue shared between the terminal process and the application.
+ *
+ * Single producer (the terminal process), single consumer (the application),
+ * so the two may run on different cores.
+ */
+typedef struct {
+    terminal_core_entry_t queue[TERMINAL_CORE_QUEUE_LEN];
+
+    /// Write and read counters (free-running; queue index is counter % TERMINAL_CORE_QUEUE_LEN)
+    volatile uint32_t head;
+    volatile uint32_t tail;
 
-    /// True when a new command is ready for processing (set by Core 1, cleared by Core 0)
-    volatile bool command_ready;
+    /// Commands discarded because the queue was full
+    volatile uint32_t dropped;
 
-    // Add more flags or fields as needed (e.g., for signaling results or tasks)
+    /// PID of the process woken when a command is queued, or -1
+    int consumer_pid;
+
+    /// PID of the terminal process, or -1 before terminal_core_launch()
+    int pid;
 } terminal_core_state_t;
 
 /// Global shared terminal state
 extern terminal_core_state_t terminal_state;
 
 /**
- * @brief Launch the terminal loop on Core 1.
+ * @brief Create the terminal process.
+ *
+ * The process runs at TERMINAL_CORE_PRIORITY. Each dispatch drains the
+ * received characters, queues the complete lines and blocks; the stdio
+ * chars-available callback unblocks it, so it is not dispatched while the
+ * link is idle.
+ * Call after init_scheduler() / Kernel::init().
+ *
+ * @return PID of the terminal process, or -1 if the process table is full.
+ */
+int terminal_core_launch(void);
+
+/**
+ * @brief Take the oldest received command from the queue.
+ * @param out Destination for the command and payload.
+ * @return true if a command was copied, false if the queue is empty.
+ */
+bool terminal_core_next(terminal_core_entry_t* out);
+
+/// @brief Number of commands waiting in the queue.
+uint32_t terminal_core_pending(void);
+
+/**
+ * @brief Wake a process whenever a command is queued.
+ *
+ * The consumer can drain the queue, then process_block() and return.
  *
- * Initializes terminal and starts a loop that listens for user input.
- * Populates `terminal_state` with commands typed from the terminal.
+ * @param pid PID to unblock, or -1 to stop notifying.
  */
-void terminal_core_launch(void);
+void terminal_core_set_consumer(int pid);
 
 #ifdef __cplusplus
 }
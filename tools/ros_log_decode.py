@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""Decode Rohini RTOS binary log records (ros_log_drain_binary) on the host.
+
+Each record names its ROS_LOG() call site by address. The site descriptor,
+its format string and any %s arguments are read back from the firmware ELF,
+so the target never formats anything.
+
+Usage:
+    ros_log_decode.py firmware.elf capture.bin
+    ros_log_decode.py firmware.elf /dev/ttyACM0 --baud 115200   (needs pyserial)
+    ros_log_decode.py firmware.elf -                            (stdin)
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+FRAME_SYNC = b"\xA5\x5A"
+DROPPED_SITE = 0
+
+CONVERSION = re.compile(r"%[-+ #0]*(\d+|\*)?(\.\d+)?(hh|h|ll|l|z|j|t)?([diouxXcsp%])")
+
+
+class Elf32:
+    """Just enough of an ELF32 little-endian reader to resolve addresses."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError(f"{path}: not a 32-bit little-endian ELF")
+
+        shoff, = struct.unpack_from("<I", self.data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2E)
+
+        self.sections = []
+        for i in range(shnum):
+            _, sh_type, _, addr, offset, size = struct.unpack_from("<IIIIII", self.data, shoff + i * shentsize)
+            # SHT_PROGBITS sections with a load address hold code, rodata and our site table
+            if sh_type == 1 and addr != 0:
+                self.sections.append((addr, size, offset))
+
+    def read(self, addr, length):
+        for base, size, offset in self.sections:
+            if base <= addr and addr + length <= base + size:
+                start = offset + addr - base
+                return self.data[start:start + length]
+        raise KeyError(f"address 0x{addr:08x} not in ELF")
+
+    def read_u32(self, addr):
+        return struct.unpack("<I", self.read(addr, 4))[0]
+
+    def read_cstring(self, addr, limit=256):
+        out = bytearray()
+        while len(out) < limit:
+            c = self.read(addr + len(out), 1)[0]
+            if c == 0:
+                break
+            out.append(c)
+        return out.decode("utf-8", errors="replace")
+
+
+def format_record(elf, fmt, args):
+    """Apply a C printf format to raw 32-bit words."""
+    values = iter(args)
+
+    def convert(m):
+        conv = m.group(4)
+        if conv == "%":
+            return "%"
+        value = next(values, 0)
+        spec = m.group(0)[:-1 - len(m.group(3) or "")] if m.group(3) else m.group(0)[:-1]
+        if conv == "s":
+            try:
+                return (spec + "s") % elf.read_cstring(value)
+            except KeyError:
+                return f"<0x{value:08x}>"
+        if conv == "p":
+            return f"0x{value:08x}"
+        if conv in "di":
+            value = value - (1 << 32) if value & 0x80000000 else value
+            return (spec + "d") % value
+        if conv == "c":
+            return chr(value & 0xFF)
+        return (spec + conv) % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def frames(stream):
+    """Yield (core, words) for every frame, skipping interleaved text."""
+    buf = b""
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            return
+        buf += chunk
+        while True:
+            start = buf.find(FRAME_SYNC)
+            if start < 0:
+                buf = buf[-1:]
+                break
+            if len(buf) < start + 4:
+                buf = buf[start:]
+                break
+            core, nwords = buf[start + 2], buf[start + 3]
+            end = start + 4 + nwords * 4
+            if len(buf) < end:
+                buf = buf[start:]
+                break
+            words = struct.unpack_from(f"<{nwords}I", buf, start + 4)
+            buf = buf[end:]
+            yield core, words
+
+
+def decode(elf, stream, out):
+    for core, words in frames(stream):
+        if len(words) < 2:
+            continue
+        site, timestamp, args = words[0], words[1], words[2:]
+        if site == DROPPED_SITE:
+            out.write(f"[{timestamp:10d} c{core}] <{args[0] if args else '?'} records dropped>\n")
+            continue
+        try:
+            fmt = elf.read_cstring(elf.read_u32(site))
+        except KeyError:
+            out.write(f"[{timestamp:10d} c{core}] <unknown site 0x{site:08x}> {list(args)}\n")
+            continue
+        out.write(f"[{timestamp:10d} c{core}] {format_record(elf, fmt, args)}\n")
+        out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf", help="firmware ELF the records were produced by")
+    parser.add_argument("input", help="capture file, serial port, or - for stdin")
+    parser.add_argument("--baud", type=int, default=115200, help="baud rate for serial ports")
+    args = parser.parse_args()
+
+    elf = Elf32(args.elf)
+    if args.input == "-":
+        stream = sys.stdin.buffer
+    elif args.input.startswith("/dev/") or args.input.upper().startswith("COM"):
+        import serial  # pyserial
+        stream = serial.Serial(args.input, args.baud, timeout=None)
+    else:
+        stream = open(args.input, "rb")
+
+    try:
+        decode(elf, stream, sys.stdout)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+"""Reference host client for Rohini RTOS telemetry frames.
+
+Frames share the link with the text shell:
+
+    0x00 | COBS(channel | seq | payload | crc16_le) | 0x00
+
+Every 0x00 terminates a frame; the leading one is an empty frame that closes
+any shell text before it. Bytes outside a frame are shell text. After a frame
+fails its checks the terminating 0x00 is taken as the opener of the next one,
+so a lost byte costs one frame instead of the framing phase.
+
+Usage:
+    telemetry_client.py PORT monitor
+    telemetry_client.py PORT send CHANNEL HEXPAYLOAD
+    telemetry_client.py PORT bench [--channel 15] [--size 250] [--seconds 10] [--window 4]
+
+The bench mode needs telemetry_enable_loopback(CHANNEL) on the target and
+reports the echoed payload throughput, round-trip latency and link errors.
+Requires pyserial.
+"""
+
+import argparse
+import os
+import sys
+import time
+
+DELIMITER = 0x00
+MAX_PAYLOAD = 250
+MAX_ENCODED = MAX_PAYLOAD + 4 + 1
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT-FALSE."""
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_at, code = 0, 1
+    for b in data:
+        if b == 0:
+            out[code_at] = code
+            code_at, code = len(out), 1
+            out.append(0)
+            continue
+        out.append(b)
+        code += 1
+        if code == 0xFF:
+            out[code_at] = code
+            code_at, code = len(out), 1
+            out.append(0)
+    out[code_at] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            raise ValueError("bad COBS")
+        out += data[i:i + code - 1]
+        i += code - 1
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class Link:
+    """Splits the incoming byte stream into shell text and checked frames."""
+
+    def __init__(self, port):
+        self.port = port
+        self.tx_seq = {}
+        self.rx_seq = {}
+        self.in_frame = False
+        self.frame = bytearray()
+        self.stats = {"rx_frames": 0, "crc_errors": 0, "bad_frames": 0, "seq_gaps": 0}
+
+    def send(self, channel, payload):
+        if len(payload) > MAX_PAYLOAD:
+            raise ValueError(f"payload longer than {MAX_PAYLOAD} bytes")
+        seq = self.tx_seq.get(channel, 0)
+        self.tx_seq[channel] = (seq + 1) & 0xFF
+        body = bytes([channel, seq]) + bytes(payload)
+        crc = crc16(body)
+        self.port.write(bytes([DELIMITER]) + cobs_encode(body + bytes([crc & 0xFF, crc >> 8])) + bytes([DELIMITER]))
+
+    def poll(self, on_text, on_frame):
+        data = self.port.read(self.port.in_waiting or 1)
+        text = bytearray()
+        for b in data:
+            if not self.in_frame:
+                if b == DELIMITER:
+                    self.in_frame = True
+                    self.frame.clear()
+                else:
+                    text.append(b)
+                continue
+            if b != DELIMITER:
+                if len(self.frame) == MAX_ENCODED:
+                    # Longer than any frame: text after a stray zero
+                    self.stats["bad_frames"] += 1
+                    self.in_frame = False
+                    text.append(b)
+                else:
+                    self.frame.append(b)
+                continue
+            # Empty frames keep framing armed; so does a rejected one, to resync on the next
+            if self.frame:
+                self.in_frame = not self._frame(on_frame)
+                self.frame.clear()
+        if text:
+            on_text(bytes(text))
+
+    def _frame(self, on_frame):
+        try:
+            f = cobs_decode(bytes(self.frame))
+        except ValueError:
+            self.stats["bad_frames"] += 1
+            return False
+        if len(f) < 4:
+            self.stats["bad_frames"] += 1
+            return False
+        if crc16(f[:-2]) != (f[-2] | f[-1] << 8):
+            self.stats["crc_errors"] += 1
+            return False
+        channel, seq = f[0], f[1]
+        if channel in self.rx_seq:
+            self.stats["seq_gaps"] += (seq - self.rx_seq[channel] - 1) & 0xFF
+        self.rx_seq[channel] = seq
+        self.stats["rx_frames"] += 1
+        on_frame(channel, seq, f[2:-2])
+        return True
+
+
+def monitor(link):
+    def text(data):
+        sys.stdout.write(data.decode("utf-8", errors="replace"))
+        sys.stdout.flush()
+
+    def frame(channel, seq, payload):
+        print(f"\n[ch{channel} #{seq:3d}] {payload.hex()}")
+
+    while True:
+        link.poll(text, frame)
+
+
+def bench(link, channel, size, seconds, window):
+    payload_base = os.urandom(size)
+    outstanding = {}
+    rtts = []
+    echoed = 0
+    mismatched = 0
+    tag = 0
+
+    def frame(ch, seq, payload):
+        nonlocal echoed, mismatched
+        if ch != channel or len(payload) < 2:
+            return
+        key = payload[0] | payload[1] << 8
+        sent = outstanding.pop(key, None)
+        if sent is None:
+            return
+        if payload[2:] != payload_base[2:]:
+            mismatched += 1
+        rtts.append(time.perf_counter() - sent)
+        echoed += len(payload)
+
+    start = time.perf_counter()
+    deadline = start + seconds
+    while time.perf_counter() < deadline:
+        while len(outstanding) < window:
+            payload = bytes([tag & 0xFF, tag >> 8 & 0xFF]) + payload_base[2:]
+            outstanding[tag] = time.perf_counter()
+            link.send(channel, payload)
+            tag = (tag + 1) & 0xFFFF
+        link.poll(lambda _: None, frame)
+        # Frames lost on the link are retired after a second so the window keeps moving
+        now = time.perf_counter()
+        for key in [k for k, t in outstanding.items() if now - t > 1.0]:
+            del outstanding[key]
+    elapsed = time.perf_counter() - start
+
+    rtts.sort()
+    print(f"payload      {size} B, window {window}, {elapsed:.1f} s")
+    print(f"echoed       {len(rtts)} frames, {echoed / elapsed / 1024:.1f} KiB/s payload each way")
+    if rtts:
+        print(f"rtt          min {rtts[0] * 1e3:.2f} ms  avg {sum(rtts) / len(rtts) * 1e3:.2f} ms  "
+              f"p99 {rtts[int(len(rtts) * 0.99) - 1 if len(rtts) > 1 else 0] * 1e3:.2f} ms  max {rtts[-1] * 1e3:.2f} ms")
+    print(f"errors       mismatched {mismatched}, " + ", ".join(f"{k} {v}" for k, v in link.stats.items() if k != "rx_frames"))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port", help="serial port, e.g. /dev/ttyACM0")
+    parser.add_argument("--baud", type=int, default=115200, help="baud rate (ignored by USB CDC)")
+    sub = parser.add_subparsers(dest="mode", required=True)
+    sub.add_parser("monitor", help="print shell text and decoded frames")
+    send = sub.add_parser("send", help="send one frame")
+    send.add_argument("channel", type=int)
+    send.add_argument("payload", help="payload as hex")
+    b = sub.add_parser("bench", help="loopback throughput benchmark")
+    b.add_argument("--channel", type=int, default=15)
+    b.add_argument("--size", type=int, default=MAX_PAYLOAD)
+    b.add_argument("--seconds", type=float, default=10.0)
+    b.add_argument("--window", type=int, default=4, help="frames in flight")
+    args = parser.parse_args()
+
+    import serial  # pyserial
+    link = Link(serial.Serial(args.port, args.baud, timeout=0.05))
+
+    try:
+        if args.mode == "monitor":
+            monitor(link)
+        elif args.mode == "send":
+            link.send(args.channel, bytes.fromhex(args.payload))
+        else:
+            bench(link, args.channel, max(2, min(args.size, MAX_PAYLOAD)), args.seconds, args.window)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
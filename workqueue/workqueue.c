@@ -0,0 +1,127 @@
+#include "workqueue.h"
+#include "scheduler.h"
+#include "ros_hot.h"
+#include "xip_profile.h"
+#include "timebase.h"
+#include "hardware/sync.h"
+
+_Static_assert((WORKQUEUE_LEN & (WORKQUEUE_LEN - 1)) == 0, "WORKQUEUE_LEN must be a power of two");
+
+typedef struct {
+    workqueue_item_t* ring[WORKQUEUE_LEN];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    workqueue_stats_t stats;
+} workqueue_t;
+
+static workqueue_t queues[NUM_CORES];
+static uint next_core;                  // Drain alternates between the queues
+
+// One lock for both queues: the pending test-and-set must be atomic across cores
+static spin_lock_t* workqueue_lock;
+static int worker_pid = -1;
+
+void workqueue_item_init(workqueue_item_t* item, workqueue_fn_t fn, void* ctx) {
+    item->fn = fn;
+    item->ctx = ctx;
+    item->pending = false;
+    item->posted_us = 0;
+}
+
+bool ROS_HOT(workqueue_post)(workqueue_item_t* item) {
+    if (!workqueue_lock) return false;
+    workqueue_t* q = &queues[get_core_num()];
+    xip_profile_mark_t xip = xip_profile_begin();
+
+    uint32_t irq = spin_lock_blocking(workqueue_lock);
+    if (item->pending) {
+        q->stats.coalesced++;
+        spin_unlock(workqueue_lock, irq);
+        return true;
+    }
+    uint32_t depth = q->head - q->tail;
+    if (depth >= WORKQUEUE_LEN) {
+        q->stats.dropped++;
+        spin_unlock(workqueue_lock, irq);
+        return false;
+    }
+    item->pending = true;
+    item->posted_us = timebase_now_us32();
+    q->ring[q->head % WORKQUEUE_LEN] = item;
+    q->head++;
+    q->stats.posted++;
+    if (depth + 1 > q->stats.max_depth) q->stats.max_depth = depth + 1;
+    spin_unlock(workqueue_lock, irq);
+
+    process_unblock(worker_pid);
+    xip_profile_end(XIP_PROFILE_WORKQUEUE, xip);
+    return true;
+}
+
+// Pop the next item, alternating between cores so neither queue starves the other
+static workqueue_item_t* ROS_HOT(workqueue_take)(void) {
+    workqueue_item_t* item = NULL;
+    uint32_t irq = spin_lock_blocking(workqueue_lock);
+    for (uint n = 0; n < NUM_CORES && !item; n++) {
+        workqueue_t* q = &queues[(next_core + n) % NUM_CORES];
+        if (q->head == q->tail) continue;
+        item = q->ring[q->tail % WORKQUEUE_LEN];
+        q->tail++;
+        // Cleared before the item runs, so a post from inside it queues it again
+        item->pending = false;
+
+        uint32_t latency = timebase_now_us32() - item->posted_us;
+        q->stats.executed++;
+        q->stats.total_latency_us += latency;
+        if (latency > q->stats.max_latency_us) q->stats.max_latency_us = latency;
+    }
+    next_core = (next_core + 1) % NUM_CORES;
+    spin_unlock(workqueue_lock, irq);
+    return item;
+}
+
+uint32_t workqueue_drain(void) {
+    if (!workqueue_lock) return 0;
+    uint32_t n = 0;
+    workqueue_item_t* item;
+    while ((item = workqueue_take()) != NULL) {
+        item->fn(item->ctx);
+        n++;
+    }
+    return n;
+}
+
+// One drain per dispatch; the next post makes the worker READY again
+static void workqueue_worker(void) {
+    do {
+        workqueue_drain();
+    } while (!process_block());   // false: an item was posted during the drain
+}
+
+int workqueue_launch(uint8_t priority) {
+    if (!workqueue_lock) workqueue_lock = spin_lock_instance((uint)spin_lock_claim_unused(true));
+    worker_pid = create_process(workqueue_worker, priority);
+    return worker_pid;
+}
+
+uint32_t workqueue_depth(uint core) {
+    return queues[core].head - queues[core].tail;
+}
+
+void workqueue_get_stats(uint core, workqueue_stats_t* out) {
+    // Nothing is counted before workqueue_launch()
+    if (!workqueue_lock) {
+        *out = (workqueue_stats_t){0};
+        return;
+    }
+    uint32_t irq = spin_lock_blocking(workqueue_lock);
+    *out = queues[core].stats;
+    spin_unlock(workqueue_lock, irq);
+}
+
+void workqueue_reset_stats(void) {
+    if (!workqueue_lock) return;
+    uint32_t irq = spin_lock_blocking(workqueue_lock);
+    for (uint c = 0; c < NUM_CORES; c++) queues[c].stats = (workqueue_stats_t){0};
+    spin_unlock(workqueue_lock, irq);
+}
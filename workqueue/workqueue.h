@@ -0,0 +1,110 @@
+#pragma once
+/**
+ * @file workqueue.h
+ * @brief Deferred interrupt work (bottom halves) run by a kernel worker process.
+ *
+ * An interrupt handler posts a work item (function + context) and returns;
+ * the worker process runs it later at its own priority. Each core posts into
+ * its own FIFO. An item that is already queued is not queued again: repeated
+ * posts before it runs coalesce into one execution.
+ */
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Items each core's queue holds (power of two); distinct items, since a queued item is never added twice
+#ifndef WORKQUEUE_LEN
+#define WORKQUEUE_LEN 16
+#endif
+
+typedef void (*workqueue_fn_t)(void* ctx);
+
+/**
+ * @struct workqueue_item_t
+ * @brief One unit of deferred work, in caller-provided storage (usually static).
+ *
+ * pending    – queued and not yet started; posts in this state coalesce
+ * posted_us  – timebase (low 32 bits) of the first post since the item last ran
+ */
+typedef struct {
+    workqueue_fn_t fn;
+    void* ctx;
+    volatile bool pending;
+    uint32_t posted_us;
+} workqueue_item_t;
+
+/// Static initializer for a workqueue_item_t
+#define WORKQUEUE_ITEM_INIT(fn_, ctx_) { .fn = (fn_), .ctx = (ctx_), .pending = false, .posted_us = 0 }
+
+/**
+ * @struct workqueue_stats_t
+ * @brief Statistics for one core's queue.
+ *
+ * posted           – posts that queued the item
+ * coalesced        – posts folded into an item already queued
+ * dropped          – posts lost because the queue was full
+ * executed         – items run by the worker
+ * max_depth        – deepest the queue has been
+ * max_latency_us   – longest first-post-to-start delay
+ * total_latency_us – sum of those delays (divide by executed for the mean)
+ */
+typedef struct {
+    uint32_t posted;
+    uint32_t coalesced;
+    uint32_t dropped;
+    uint32_t executed;
+    uint32_t max_depth;
+    uint32_t max_latency_us;
+    uint64_t total_latency_us;
+} workqueue_stats_t;
+
+/// @brief Initialize an item at run time (equivalent to WORKQUEUE_ITEM_INIT).
+void workqueue_item_init(workqueue_item_t* item, workqueue_fn_t fn, void* ctx);
+
+/**
+ * @brief Claim the queue lock and create the worker process.
+ *
+ * Call after init_scheduler() and before enabling interrupts that post.
+ * @param priority Worker priority; above the tasks that consume the results,
+ *                 below anything that must not wait behind driver work.
+ * @return PID of the worker, or -1 if the process table is full.
+ */
+int workqueue_launch(uint8_t priority);
+
+/**
+ * @brief Queue an item on the calling core's queue and wake the worker.
+ *
+ * Safe from interrupt handlers, processes and either core.
+ * @return true if the item will run (queued now or already pending),
+ *         false if the queue was full or workqueue_launch() has not run.
+ */
+bool workqueue_post(workqueue_item_t* item);
+
+/**
+ * @brief Run every queued item in the calling context.
+ *
+ * The worker process calls this once per dispatch, then blocks until the
+ * next post; a main loop without a worker may call it too.
+ * @return Number of items run.
+ */
+uint32_t workqueue_drain(void);
+
+/// @return Items waiting on `core`'s queue.
+uint32_t workqueue_depth(uint core);
+
+/**
+ * @brief Copy out one core's statistics.
+ * @param core Core whose queue to read (0 or 1).
+ * @param out  Destination.
+ */
+void workqueue_get_stats(uint core, workqueue_stats_t* out);
+
+/// @brief Clear the statistics of both queues.
+void workqueue_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif